@@ -0,0 +1,222 @@
+/**
+ * book.c - Opening book storage, lookup and precomputation
+ *
+ * The book is a table of second guesses indexed by strategy and opener
+ * feedback code. BOOK_FILE is plain text:
+ *
+ *   # opening book version=<BOOK_VERSION> words=<wordList hash> solutions=<solutionList hash>
+ *   ENTROPY STARE BBBBB MOIST
+ *
+ * and is rewritten through a temporary file only by book_build(), so
+ * ordinary games never modify it.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <inttypes.h>
+#include <unistd.h>
+#include <pthread.h>
+#include "book.h"
+#include "feedback.h"
+#include "pool.h"
+
+// ============= Constants =============
+#define BOOK_STRATEGIES STRATEGY_TREE   // Strategies that search (and have a book)
+#define BOOK_LINE_LENGTH 128
+
+// ============= Global Variables =============
+static const char* strategy_names[BOOK_STRATEGIES] = {"ENTROPY", "MINIMAX", "FREQUENCY"};
+
+// Packed moves; PACKED_INVALID means "not in the book"
+static uint32_t moves[BOOK_STRATEGIES][PATTERN_COUNT];
+static bool book_loaded = false;
+static pthread_mutex_t book_lock = PTHREAD_MUTEX_INITIALIZER;
+
+/**
+ * Shared state of one book_build() run
+ */
+typedef struct {
+    Strategy strategy;
+    int next;                                         // Next code to compute
+    uint32_t found[PATTERN_COUNT];                    // Computed moves, PACKED_INVALID if none
+} BuildJob;
+
+// ============= File Functions =============
+
+/**
+ * Finds a strategy by its name in the book file
+ * @return Strategy index, or -1 if unknown
+ */
+static int strategy_by_name(const char* name) {
+    for (int s = 0; s < BOOK_STRATEGIES; s++) {
+        if (strcmp(strategy_names[s], name) == 0) return s;
+    }
+    return -1;
+}
+
+/**
+ * Reads BOOK_FILE into the table
+ * Called with book_lock held. Lines naming another opener, unknown words
+ * or malformed patterns are skipped, and the whole file is ignored if it
+ * was written for different word lists or another BOOK_VERSION.
+ */
+static void load_book(void) {
+    if (book_loaded) return;
+    book_loaded = true;
+    for (int s = 0; s < BOOK_STRATEGIES; s++) {
+        for (int code = 0; code < PATTERN_COUNT; code++) {
+            moves[s][code] = PACKED_INVALID;
+        }
+    }
+
+    FILE* file = fopen(BOOK_FILE, "r");
+    if (!file) return;
+
+    char line[BOOK_LINE_LENGTH];
+    int version = 0;
+    uint64_t words_hash = 0, solutions_hash = 0;
+    if (!fgets(line, sizeof(line), file) ||
+        sscanf(line, "# opening book version=%d words=%" SCNx64 " solutions=%" SCNx64,
+               &version, &words_hash, &solutions_hash) != 3 ||
+        version != BOOK_VERSION || words_hash != hashWords(wordList, wordCount) ||
+        solutions_hash != hashWords(solutionList, solutionCount)) {
+        printf("Ignoring %s: made for other word lists or strategies\n", BOOK_FILE);
+        fclose(file);
+        return;
+    }
+
+    int entries = 0;
+    while (fgets(line, sizeof(line), file)) {
+        char name[16], opener[WORD_LENGTH + 1], pattern[WORD_LENGTH + 1], guess[WORD_LENGTH + 1];
+        if (sscanf(line, "%15s %5s %5s %5s", name, opener, pattern, guess) != 4) continue;
+
+        int s = strategy_by_name(name);
+        uint8_t code = encodeFeedback(pattern);
+        uint32_t packed = packCanonical(guess);
+        if (s < 0 || code == PATTERN_INVALID || packCanonical(opener) != packWord(SOLVER_OPENER) ||
+            dictionary_find(packed) < 0) {
+            continue;
+        }
+        moves[s][code] = packed;
+        entries++;
+    }
+    fclose(file);
+    printf("Loaded %d opening book moves from %s\n", entries, BOOK_FILE);
+}
+
+/**
+ * Writes the whole table to BOOK_FILE
+ * Called with book_lock held; goes through a temporary file so a reader
+ * never sees a partial book.
+ */
+static bool save_book(void) {
+    char temp_name[256];
+    snprintf(temp_name, sizeof(temp_name), "%s.%ld.tmp", BOOK_FILE, (long)getpid());
+
+    FILE* file = fopen(temp_name, "w");
+    if (!file) return false;
+
+    fprintf(file, "# opening book version=%d words=%016" PRIx64 " solutions=%016" PRIx64 "\n",
+            BOOK_VERSION, hashWords(wordList, wordCount), hashWords(solutionList, solutionCount));
+    for (int s = 0; s < BOOK_STRATEGIES; s++) {
+        for (int code = 0; code < PATTERN_COUNT; code++) {
+            if (moves[s][code] == PACKED_INVALID) continue;
+            char pattern[WORD_LENGTH + 1], guess[WORD_LENGTH + 1];
+            decodeFeedback((uint8_t)code, pattern);
+            unpackWord(moves[s][code], guess);
+            fprintf(file, "%s %s %s %s\n", strategy_names[s], SOLVER_OPENER, pattern, guess);
+        }
+    }
+
+    bool ok = fclose(file) == 0;
+    if (!ok || rename(temp_name, BOOK_FILE) != 0) {
+        remove(temp_name);
+        return false;
+    }
+    return true;
+}
+
+// ============= Book Functions =============
+
+bool book_lookup(Strategy strategy, uint8_t code, char guess[WORD_LENGTH + 1]) {
+    if ((int)strategy >= BOOK_STRATEGIES || code >= PATTERN_COUNT) return false;
+
+    pthread_mutex_lock(&book_lock);
+    load_book();
+    bool found = moves[strategy][code] != PACKED_INVALID;
+    if (found) {
+        unpackWord(moves[strategy][code], guess);
+    }
+    pthread_mutex_unlock(&book_lock);
+    return found;
+}
+
+void book_record(Strategy strategy, uint8_t code, const char guess[WORD_LENGTH + 1]) {
+    if ((int)strategy >= BOOK_STRATEGIES || code >= PATTERN_COUNT) return;
+
+    pthread_mutex_lock(&book_lock);
+    load_book();
+    uint32_t packed = packWord(guess);
+    if (packed != PACKED_INVALID) {
+        moves[strategy][code] = packed;
+    }
+    pthread_mutex_unlock(&book_lock);
+}
+
+/**
+ * Pool job: plays the opener against each code and records the reply
+ * Workers take codes one at a time since partitions differ widely in size.
+ */
+static void build_worker(void* arg, int worker, int workers) {
+    BuildJob* job = (BuildJob*)arg;
+    (void)worker;
+    (void)workers;
+
+    SolverContext ctx;
+    solver_init(&ctx, job->strategy);
+    ctx.use_book = false;
+
+    int code;
+    while ((code = __atomic_fetch_add(&job->next, 1, __ATOMIC_RELAXED)) < PATTERN_COUNT) {
+        job->found[code] = PACKED_INVALID;
+        if (code == PATTERN_WIN) continue;
+
+        solver_new_game(&ctx);
+        solver_next_guess(&ctx);
+        solver_observe(&ctx, SOLVER_OPENER, (uint8_t)code);
+        if (solver_candidate_count(&ctx) <= 1) continue;  // Nothing to search for
+
+        const char* guess = solver_next_guess(&ctx);
+        if (guess) {
+            job->found[code] = packWord(guess);
+        }
+    }
+}
+
+int book_build(Strategy strategy) {
+    if ((int)strategy >= BOOK_STRATEGIES) return 0;
+    feedback_init();
+
+    pthread_mutex_lock(&book_lock);
+    load_book();
+    pthread_mutex_unlock(&book_lock);
+
+    BuildJob* job = (BuildJob*)malloc(sizeof(BuildJob));
+    if (!job) return 0;
+    job->strategy = strategy;
+    job->next = 0;
+    pool_run(build_worker, job);
+
+    int entries = 0;
+    pthread_mutex_lock(&book_lock);
+    for (int code = 0; code < PATTERN_COUNT; code++) {
+        moves[strategy][code] = job->found[code];   // Replaces the old move, if any
+        if (moves[strategy][code] != PACKED_INVALID) entries++;
+    }
+    save_book();
+    pthread_mutex_unlock(&book_lock);
+
+    free(job);
+    return entries;
+}
@@ -0,0 +1,55 @@
+/**
+ * book.h - Opening book of second guesses
+ *
+ * After the fixed opener the game state depends only on the opener's
+ * feedback code, so each searching strategy has at most 243 distinct
+ * second moves. The book keeps them per strategy and serves them with a
+ * table lookup. book_build() computes them all at once and saves them in
+ * BOOK_FILE; live games only read the file, and moves they search for are
+ * kept in memory for the rest of the process.
+ */
+
+#ifndef BOOK_H
+#define BOOK_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "wordle.h"
+#include "solver.h"
+
+// ============= Constants =============
+#define BOOK_FILE "opening_book.txt"   // On-disk book, one move per line
+#define BOOK_VERSION 2                 // Bump whenever a strategy may choose another move
+
+// ============= Book Functions =============
+
+/**
+ * Looks up the second guess after SOLVER_OPENER
+ * Loads BOOK_FILE on first use; a file made for other word lists or another
+ * BOOK_VERSION is ignored.
+ * @param strategy Searching strategy (not STRATEGY_TREE)
+ * @param code Feedback code received for the opener
+ * @param guess Output buffer for the second guess
+ * @return true if the book has a move for this code
+ */
+bool book_lookup(Strategy strategy, uint8_t code, char guess[WORD_LENGTH + 1]);
+
+/**
+ * Adds a second guess to the in-memory book; BOOK_FILE is not written
+ * @param strategy Searching strategy (not STRATEGY_TREE)
+ * @param code Feedback code received for the opener
+ * @param guess Second guess chosen by the live search
+ */
+void book_record(Strategy strategy, uint8_t code, const char guess[WORD_LENGTH + 1]);
+
+/**
+ * Recomputes the second guess for all opener codes of a strategy and saves BOOK_FILE
+ * The strategy's old moves are replaced. Codes are spread over the worker
+ * pool, one solver context per worker; codes leaving at most one candidate
+ * get no entry.
+ * @param strategy Searching strategy (not STRATEGY_TREE)
+ * @return Number of moves in the strategy's book
+ */
+int book_build(Strategy strategy);
+
+#endif
@@ -0,0 +1,429 @@
+/**
+ * builder.c - Decision tree generation
+ *
+ * Answer sets are plain arrays of wordList indices. Splitting a set by a
+ * guess is a counting sort on the guess's feedback row, so every child
+ * set is a contiguous slice of its parent's scratch array.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <pthread.h>
+#include "builder.h"
+#include "candidates.h"
+#include "feedback.h"
+#include "pool.h"
+
+// ============= Global Variables =============
+static _Thread_local uint8_t row_scratch[MAX_WORDS];  // Feedback row when there is no matrix
+
+// c * log2(c) for every bucket size, shared read-only once filled
+static double bucket_cost[MAX_WORDS + 1];
+static pthread_once_t bucket_cost_once = PTHREAD_ONCE_INIT;
+
+/**
+ * Per-thread generation state
+ */
+typedef struct {
+    const BuilderOptions* options;
+    bool failed;                      // An allocation failed
+    int rebuilt;                      // Subtrees generated by a repair
+} Builder;
+
+/**
+ * A guess ranked by the split it makes
+ */
+typedef struct {
+    int index;         // wordList index
+    double score;      // Sum of c * log2(c) over the buckets; lower is better
+    bool in_set;       // The guess is one of the answers
+} RankedGuess;
+
+/**
+ * One subtree below the opener, built by one pool worker
+ */
+typedef struct {
+    uint8_t code;        // Opener feedback leading here
+    const int* set;      // Answers of the subtree
+    int count;
+    DecisionTree tree;   // Subtree, rooted at its own TREE_ROOT
+    TreeStats stats;
+    bool ok;
+} SubtreeJob;
+
+/**
+ * Shared state of the subtree jobs
+ */
+typedef struct {
+    SubtreeJob* jobs;
+    int* order;                      // Job indices, largest subtree first
+    int job_count;
+    int next;                        // Next position in order to claim
+    const BuilderOptions* options;
+} BuildRun;
+
+// ============= Scoring Helpers =============
+
+static void fill_bucket_cost(void) {
+    bucket_cost[0] = 0.0;
+    for (int c = 1; c <= MAX_WORDS; c++) {
+        bucket_cost[c] = c * log2((double)c);
+    }
+}
+
+/**
+ * Adds one solved answer to the statistics
+ */
+static void record_answer(TreeStats* stats, int depth, const BuilderOptions* options) {
+    stats->answers++;
+    stats->total_guesses += depth;
+    if (depth > stats->max_depth) stats->max_depth = depth;
+    if (depth > options->max_depth) stats->failures++;
+}
+
+/**
+ * Orders trees: fewer failures, then fewer guesses, then shallower
+ */
+static bool better_stats(const TreeStats* a, const TreeStats* b) {
+    if (a->failures != b->failures) return a->failures < b->failures;
+    if (a->total_guesses != b->total_guesses) return a->total_guesses < b->total_guesses;
+    return a->max_depth < b->max_depth;
+}
+
+static void merge_stats(TreeStats* total, const TreeStats* part) {
+    total->answers += part->answers;
+    total->total_guesses += part->total_guesses;
+    total->failures += part->failures;
+    if (part->max_depth > total->max_depth) total->max_depth = part->max_depth;
+}
+
+/**
+ * Orders ranked guesses: better split, then answers first, then dictionary order
+ */
+static bool better_guess(const RankedGuess* a, const RankedGuess* b) {
+    if (a->score != b->score) return a->score < b->score;
+    if (a->in_set != b->in_set) return a->in_set;
+    return a->index < b->index;
+}
+
+/**
+ * Keeps the best guesses for splitting a set
+ * Guesses that leave every answer in one non-winning bucket are skipped.
+ * @param top Output, best first
+ * @return Number of guesses stored (at most width)
+ */
+static int rank_guesses(const int* set, int count, int width, RankedGuess* top) {
+    CandidateSet members;
+    candidates_clear(&members);
+    for (int i = 0; i < count; i++) {
+        candidates_add(&members, set[i]);
+    }
+
+    int kept = 0;
+    int counts[PATTERN_COUNT];
+    for (int g = 0; g < wordCount; g++) {
+        const uint8_t* row = feedback_scan(g, row_scratch);
+        memset(counts, 0, sizeof(counts));
+        for (int i = 0; i < count; i++) {
+            counts[row[set[i]]]++;
+        }
+
+        RankedGuess guess = { g, 0.0, candidates_contains(&members, g) };
+        bool splits = guess.in_set;
+        for (int c = 0; c < PATTERN_COUNT; c++) {
+            if (counts[c] == count) break;
+            if (counts[c]) {
+                guess.score += bucket_cost[counts[c]];
+                splits = true;
+            }
+        }
+        if (!splits) continue;
+
+        // Insert into the sorted top list
+        if (kept == width && !better_guess(&guess, &top[kept - 1])) continue;
+        int i = kept < width ? kept++ : kept - 1;
+        while (i > 0 && better_guess(&guess, &top[i - 1])) {
+            top[i] = top[i - 1];
+            i--;
+        }
+        top[i] = guess;
+    }
+    return kept;
+}
+
+/**
+ * Sorts a set into buckets by the guess's feedback
+ * @param buckets Output, answers grouped by code
+ * @param offsets Output, bucket c is buckets[offsets[c] .. offsets[c + 1])
+ */
+static void partition(int guess, const int* set, int count, int* buckets,
+                      int offsets[PATTERN_COUNT + 1]) {
+    const uint8_t* row = feedback_scan(guess, row_scratch);
+    int fill[PATTERN_COUNT] = {0};
+    for (int i = 0; i < count; i++) {
+        fill[row[set[i]]]++;
+    }
+    offsets[0] = 0;
+    for (int c = 0; c < PATTERN_COUNT; c++) {
+        offsets[c + 1] = offsets[c] + fill[c];
+        fill[c] = offsets[c];
+    }
+    for (int i = 0; i < count; i++) {
+        buckets[fill[row[set[i]]]++] = set[i];
+    }
+}
+
+// ============= Tree Expansion =============
+
+static int expand(Builder* b, DecisionTree* tree, const int* set, int count, int depth,
+                  int beam, TreeStats* stats);
+
+/**
+ * Plays a given guess on a set and expands every bucket below it
+ * @param tree Tree to add nodes to, or NULL to only compute statistics
+ * @return Node of the guess, TREE_NONE if tree is NULL or on failure
+ */
+static int expand_guess(Builder* b, DecisionTree* tree, const int* set, int count, int depth,
+                        int guess, int beam, TreeStats* stats) {
+    int* buckets = (int*)malloc(count * sizeof(int));
+    if (!buckets) {
+        b->failed = true;
+        return TREE_NONE;
+    }
+    int offsets[PATTERN_COUNT + 1];
+    partition(guess, set, count, buckets, offsets);
+
+    bool solves = offsets[PATTERN_WIN + 1] > offsets[PATTERN_WIN];
+    if (solves) {
+        record_answer(stats, depth, b->options);
+    }
+
+    int node = TREE_NONE;
+    if (tree) {
+        node = tree_add_node(tree, wordPacked[guess] | (solves ? TREE_SOLVES : 0));
+        if (node == TREE_NONE) b->failed = true;
+    }
+
+    for (int code = 0; code < PATTERN_COUNT && !b->failed; code++) {
+        int size = offsets[code + 1] - offsets[code];
+        if (code == PATTERN_WIN || size == 0) continue;
+
+        int child = expand(b, tree, buckets + offsets[code], size, depth + 1, beam, stats);
+        if (tree && !b->failed && !tree_set_child(tree, node, (uint8_t)code, child)) {
+            b->failed = true;
+        }
+    }
+
+    free(buckets);
+    return node;
+}
+
+/**
+ * Chooses the guess for a set and expands it
+ * With one or two answers left the first is guessed directly. Otherwise
+ * the best `beam` guesses by entropy are each completed greedily and the
+ * cheapest completion wins.
+ */
+static int expand(Builder* b, DecisionTree* tree, const int* set, int count, int depth,
+                  int beam, TreeStats* stats) {
+    int guess = set[0];
+    if (count > 2) {
+        RankedGuess top[BUILDER_MAX_BEAM];
+        int kept = rank_guesses(set, count, beam, top);
+        if (kept > 0) guess = top[0].index;
+
+        TreeStats best;
+        for (int i = 0; kept > 1 && i < kept; i++) {
+            TreeStats trial = {0, 0, 0, 0};
+            expand_guess(b, NULL, set, count, depth, top[i].index, 1, &trial);
+            if (i == 0 || better_stats(&trial, &best)) {
+                best = trial;
+                guess = top[i].index;
+            }
+        }
+    }
+    return expand_guess(b, tree, set, count, depth, guess, beam, stats);
+}
+
+// ============= Tree Repair =============
+
+/**
+ * Rebuilds the part of an old tree that a set of answers reaches
+ * @param node Old node the answers reach
+ * @return Node of the repaired subtree, TREE_NONE on failure
+ */
+static int repair(Builder* b, DecisionTree* tree, const DecisionTree* old, int node,
+                  const int* set, int count, int depth, TreeStats* stats) {
+    int guess = dictionary_find(old->nodes[node].word & TREE_WORD_MASK);
+    if (guess < 0) {
+        // The guess left the dictionary: nothing below it can be kept
+        b->rebuilt++;
+        return expand(b, tree, set, count, depth, b->options->beam_width, stats);
+    }
+
+    int* buckets = (int*)malloc(count * sizeof(int));
+    if (!buckets) {
+        b->failed = true;
+        return TREE_NONE;
+    }
+    int offsets[PATTERN_COUNT + 1];
+    partition(guess, set, count, buckets, offsets);
+
+    bool solves = offsets[PATTERN_WIN + 1] > offsets[PATTERN_WIN];
+    if (solves) {
+        record_answer(stats, depth, b->options);
+    }
+    int copy = tree_add_node(tree, wordPacked[guess] | (solves ? TREE_SOLVES : 0));
+    if (copy == TREE_NONE) b->failed = true;
+
+    for (int code = 0; code < PATTERN_COUNT && !b->failed; code++) {
+        int size = offsets[code + 1] - offsets[code];
+        if (code == PATTERN_WIN || size == 0) continue;
+
+        const int* bucket = buckets + offsets[code];
+        int old_child = tree_child(old, node, (uint8_t)code);
+        int child;
+        if (old_child != TREE_NONE) {
+            child = repair(b, tree, old, old_child, bucket, size, depth + 1, stats);
+        } else {
+            b->rebuilt++;
+            child = expand(b, tree, bucket, size, depth + 1, b->options->beam_width, stats);
+        }
+        if (!b->failed && !tree_set_child(tree, copy, (uint8_t)code, child)) {
+            b->failed = true;
+        }
+    }
+
+    free(buckets);
+    return copy;
+}
+
+// ============= Parallel Build =============
+
+/**
+ * Pool job: builds whole subtrees below the opener, largest first
+ */
+static void subtree_worker(void* arg, int worker, int workers) {
+    BuildRun* run = (BuildRun*)arg;
+    (void)worker;
+    (void)workers;
+
+    int i;
+    while ((i = __atomic_fetch_add(&run->next, 1, __ATOMIC_RELAXED)) < run->job_count) {
+        SubtreeJob* job = &run->jobs[run->order[i]];
+        Builder b = { run->options, false, 0 };
+        memset(&job->tree, 0, sizeof(job->tree));
+        expand(&b, &job->tree, job->set, job->count, 2, run->options->beam_width, &job->stats);
+        job->ok = !b.failed;
+    }
+}
+
+// ============= Builder Functions =============
+
+void builder_default_options(BuilderOptions* options) {
+    options->beam_width = 1;
+    options->max_depth = MAX_ROUNDS;
+}
+
+bool builder_build(DecisionTree* tree, const char* opener, const int* answers, int count,
+                   const BuilderOptions* options, TreeStats* stats) {
+    memset(tree, 0, sizeof(*tree));
+    int opener_index = word_index(opener);
+    if (opener_index < 0 || count <= 0 ||
+        options->beam_width < 1 || options->beam_width > BUILDER_MAX_BEAM) {
+        return false;
+    }
+
+    feedback_init();
+    pthread_once(&bucket_cost_once, fill_bucket_cost);
+
+    // Split the answers by the opener
+    int* buckets = (int*)malloc(count * sizeof(int));
+    SubtreeJob* jobs = (SubtreeJob*)calloc(PATTERN_COUNT, sizeof(SubtreeJob));
+    int* order = (int*)malloc(PATTERN_COUNT * sizeof(int));
+    if (!buckets || !jobs || !order) {
+        free(buckets);
+        free(jobs);
+        free(order);
+        return false;
+    }
+    int offsets[PATTERN_COUNT + 1];
+    partition(opener_index, answers, count, buckets, offsets);
+
+    TreeStats total = {0, 0, 0, 0};
+    bool solves = offsets[PATTERN_WIN + 1] > offsets[PATTERN_WIN];
+    if (solves) {
+        record_answer(&total, 1, options);
+    }
+
+    // One job per non-empty bucket, claimed largest first
+    int job_count = 0;
+    for (int code = 0; code < PATTERN_COUNT; code++) {
+        int size = offsets[code + 1] - offsets[code];
+        if (code == PATTERN_WIN || size == 0) continue;
+        SubtreeJob* job = &jobs[job_count];
+        job->code = (uint8_t)code;
+        job->set = buckets + offsets[code];
+        job->count = size;
+
+        int i = job_count++;
+        while (i > 0 && jobs[order[i - 1]].count < size) {
+            order[i] = order[i - 1];
+            i--;
+        }
+        order[i] = job_count - 1;
+    }
+
+    BuildRun run = { jobs, order, job_count, 0, options };
+    pool_run(subtree_worker, &run);
+
+    // Attach the subtrees in code order so the result does not depend on timing
+    bool ok = tree_add_node(tree, packWord(opener) | (solves ? TREE_SOLVES : 0)) == TREE_ROOT;
+    for (int j = 0; j < job_count; j++) {
+        ok = ok && jobs[j].ok;
+        int root = ok ? tree_copy_subtree(tree, &jobs[j].tree, TREE_ROOT) : TREE_NONE;
+        ok = root != TREE_NONE && tree_set_child(tree, TREE_ROOT, jobs[j].code, root);
+        merge_stats(&total, &jobs[j].stats);
+        tree_free(&jobs[j].tree);
+    }
+
+    free(buckets);
+    free(jobs);
+    free(order);
+    if (!ok) {
+        tree_free(tree);
+        return false;
+    }
+    if (stats) {
+        *stats = total;
+    }
+    return true;
+}
+
+bool builder_repair(DecisionTree* tree, const DecisionTree* old, const int* answers, int count,
+                    const BuilderOptions* options, TreeStats* stats, int* rebuilt) {
+    memset(tree, 0, sizeof(*tree));
+    if (old->count == 0 || count <= 0 ||
+        options->beam_width < 1 || options->beam_width > BUILDER_MAX_BEAM) {
+        return false;
+    }
+
+    feedback_init();
+    pthread_once(&bucket_cost_once, fill_bucket_cost);
+
+    Builder b = { options, false, 0 };
+    TreeStats total = {0, 0, 0, 0};
+    int root = repair(&b, tree, old, TREE_ROOT, answers, count, 1, &total);
+    if (b.failed || root != TREE_ROOT) {
+        tree_free(tree);
+        return false;
+    }
+    if (stats) {
+        *stats = total;
+    }
+    if (rebuilt) {
+        *rebuilt = b.rebuilt;
+    }
+    return true;
+}
@@ -0,0 +1,75 @@
+/**
+ * builder.h - Decision tree generation
+ *
+ * Builds a decision tree for a set of answers from a fixed opener. At each
+ * node the guesses of the whole dictionary are ranked by the entropy of
+ * the split they make; with a beam width above one, the best few are each
+ * completed greedily and the one whose subtree needs the fewest guesses
+ * is kept. Subtrees below the opener are built on the worker pool.
+ *
+ * An existing tree can also be repaired for a changed answer list: its
+ * moves are kept wherever the new answers still reach them, and only
+ * feedback branches the old tree never needed are generated.
+ */
+
+#ifndef BUILDER_H
+#define BUILDER_H
+
+#include <stdbool.h>
+#include "wordle.h"
+#include "tree.h"
+
+// ============= Constants =============
+#define BUILDER_OPENER "SALET"      // Default opener, as in tree_u.txt
+#define BUILDER_MAX_BEAM 64         // Largest beam width accepted
+
+/**
+ * Generation settings
+ */
+typedef struct {
+    int beam_width;     // Guesses tried per node; 1 = greedy entropy
+    int max_depth;      // Guesses allowed per game; longer paths count as failures
+} BuilderOptions;
+
+// ============= Builder Functions =============
+
+/**
+ * Fills options with greedy entropy and a MAX_ROUNDS depth limit
+ * @param options Options to initialize
+ */
+void builder_default_options(BuilderOptions* options);
+
+/**
+ * Builds a decision tree
+ * @param tree Output tree (overwritten; free with tree_free)
+ * @param opener First guess, must be in wordList
+ * @param answers wordList indices of the possible answers, without repeats
+ * @param count Number of answers
+ * @param options Generation settings
+ * @param stats Output quality of the tree, may be NULL
+ * @return true on success
+ */
+bool builder_build(DecisionTree* tree, const char* opener, const int* answers, int count,
+                   const BuilderOptions* options, TreeStats* stats);
+
+/**
+ * Repairs a decision tree for a new answer list
+ * The new answers are walked down the old tree. Every node they still
+ * reach keeps its guess, branches no answer reaches any more are dropped,
+ * and a subtree is generated only where answers arrive on feedback the
+ * old tree does not cover (or at a guess no longer in wordList). Parts of
+ * the tree whose answers did not change are reproduced exactly, and the
+ * work done grows with the number of added answers.
+ * @param tree Output tree (overwritten; free with tree_free)
+ * @param old Tree to repair
+ * @param answers wordList indices of the new answers, without repeats
+ * @param count Number of answers
+ * @param options Settings for the generated subtrees
+ * @param stats Output quality of the tree, may be NULL
+ * @param rebuilt Output number of subtrees generated, may be NULL
+ * @return true on success
+ */
+bool builder_repair(DecisionTree* tree, const DecisionTree* old, const int* answers, int count,
+                    const BuilderOptions* options, TreeStats* stats, int* rebuilt);
+
+#endif
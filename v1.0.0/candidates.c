@@ -0,0 +1,122 @@
+/**
+ * candidates.c - Bitset candidate set implementation
+ *
+ * Sets are scanned one 64-bit block at a time, skipping empty blocks and
+ * walking set bits with count-trailing-zeros.
+ */
+
+#include "candidates.h"
+#include <string.h>
+
+// ============= Set Functions =============
+
+void candidates_fill(CandidateSet* set, int size) {
+    memset(set->bits, 0, sizeof(set->bits));
+    int full = size >> 6;
+    for (int b = 0; b < full; b++) {
+        set->bits[b] = ~0ULL;
+    }
+    if (size & 63) {
+        set->bits[full] = (1ULL << (size & 63)) - 1;
+    }
+    set->count = size;
+}
+
+void candidates_clear(CandidateSet* set) {
+    memset(set->bits, 0, sizeof(set->bits));
+    set->count = 0;
+}
+
+void candidates_add(CandidateSet* set, int index) {
+    if (!candidates_contains(set, index)) {
+        set->bits[index >> 6] |= 1ULL << (index & 63);
+        set->count++;
+    }
+}
+
+void candidates_remove(CandidateSet* set, int index) {
+    if (candidates_contains(set, index)) {
+        set->bits[index >> 6] &= ~(1ULL << (index & 63));
+        set->count--;
+    }
+}
+
+int candidates_count(CandidateSet* set) {
+    int count = 0;
+    for (int b = 0; b < CANDIDATE_BLOCKS; b++) {
+        count += __builtin_popcountll(set->bits[b]);
+    }
+    set->count = count;
+    return count;
+}
+
+int candidates_next(const CandidateSet* set, int from) {
+    if (from < 0) from = 0;
+    int b = from >> 6;
+    if (b >= CANDIDATE_BLOCKS) return -1;
+
+    uint64_t block = set->bits[b] & (~0ULL << (from & 63));
+    while (!block) {
+        if (++b >= CANDIDATE_BLOCKS) return -1;
+        block = set->bits[b];
+    }
+    return (b << 6) + __builtin_ctzll(block);
+}
+
+/**
+ * Clears every candidate whose code differs, then recounts
+ */
+void candidates_filter(CandidateSet* set, const uint8_t* row, uint8_t code) {
+    for (int b = 0; b < CANDIDATE_BLOCKS; b++) {
+        uint64_t block = set->bits[b];
+        uint64_t keep = 0;
+        while (block) {
+            int bit = __builtin_ctzll(block);
+            block &= block - 1;
+            if (row[(b << 6) + bit] == code) {
+                keep |= 1ULL << bit;
+            }
+        }
+        set->bits[b] = keep;
+    }
+    candidates_count(set);
+}
+
+void candidates_select(CandidateSet* set, const uint8_t* row, uint8_t code, int size) {
+    memset(set->bits, 0, sizeof(set->bits));
+    int count = 0;
+    for (int i = 0; i < size; i++) {
+        if (row[i] == code) {
+            set->bits[i >> 6] |= 1ULL << (i & 63);
+            count++;
+        }
+    }
+    set->count = count;
+}
+
+void candidates_histogram(const CandidateSet* set, const uint8_t* row,
+                          int counts[PATTERN_COUNT]) {
+    memset(counts, 0, PATTERN_COUNT * sizeof(int));
+    for (int b = 0; b < CANDIDATE_BLOCKS; b++) {
+        uint64_t block = set->bits[b];
+        while (block) {
+            int bit = __builtin_ctzll(block);
+            block &= block - 1;
+            counts[row[(b << 6) + bit]]++;
+        }
+    }
+}
+
+void candidates_hash(const CandidateSet* set, uint64_t* key1, uint64_t* key2) {
+    uint64_t h1 = 14695981039346656037ULL;
+    uint64_t h2 = (uint64_t)set->count * 0x9E3779B97F4A7C15ULL;
+    for (int b = 0; b < CANDIDATE_BLOCKS; b++) {
+        h1 = (h1 ^ set->bits[b]) * 1099511628211ULL;
+        uint64_t z = h2 + set->bits[b] + 0x9E3779B97F4A7C15ULL;
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+        h2 = z ^ (z >> 31);
+    }
+    *key1 = h1;
+    *key2 = h2;
+}
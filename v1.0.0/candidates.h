@@ -0,0 +1,118 @@
+/**
+ * candidates.h - Bitset candidate sets over the dictionary
+ *
+ * A candidate set holds one bit per wordList index. Membership is a bit
+ * test, the size is a population count, and filtering by feedback
+ * clears bits in place, so a game never allocates to track candidates.
+ */
+
+#ifndef CANDIDATES_H
+#define CANDIDATES_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "wordle.h"
+
+// ============= Constants =============
+#define CANDIDATE_BLOCKS ((MAX_WORDS + 63) / 64)  // 64-bit blocks per set
+
+/**
+ * Set of wordList indices
+ */
+typedef struct {
+    uint64_t bits[CANDIDATE_BLOCKS];  // Bit i set if wordList[i] is a candidate
+    int count;                        // Number of set bits
+} CandidateSet;
+
+// ============= Set Functions =============
+
+/**
+ * Makes the set contain every index in [0, size)
+ * @param set Set to fill
+ * @param size Number of dictionary words
+ */
+void candidates_fill(CandidateSet* set, int size);
+
+/**
+ * Empties the set
+ * @param set Set to clear
+ */
+void candidates_clear(CandidateSet* set);
+
+/**
+ * Tests membership
+ * @param set Set to query
+ * @param index wordList index
+ * @return true if the word is a candidate
+ */
+static inline bool candidates_contains(const CandidateSet* set, int index) {
+    return (set->bits[index >> 6] >> (index & 63)) & 1;
+}
+
+/**
+ * Adds one index to the set
+ * @param set Set to update
+ * @param index wordList index
+ */
+void candidates_add(CandidateSet* set, int index);
+
+/**
+ * Removes one index from the set
+ * @param set Set to update
+ * @param index wordList index
+ */
+void candidates_remove(CandidateSet* set, int index);
+
+/**
+ * Recounts the set with popcount
+ * @param set Set to count
+ * @return Number of candidates
+ */
+int candidates_count(CandidateSet* set);
+
+/**
+ * Finds the next candidate at or after a position
+ * @param set Set to scan
+ * @param from First index to consider
+ * @return Smallest candidate index >= from, or -1 if none
+ */
+int candidates_next(const CandidateSet* set, int from);
+
+/**
+ * Keeps only candidates whose feedback for a guess equals a code
+ * @param set Set to filter in place
+ * @param row Feedback row of the guess, indexed by wordList index
+ * @param code Observed feedback code
+ */
+void candidates_filter(CandidateSet* set, const uint8_t* row, uint8_t code);
+
+/**
+ * Replaces the set with every index in [0, size) whose code matches
+ * Equivalent to candidates_fill() followed by candidates_filter(), in a
+ * single sequential pass over the row.
+ * @param set Set to overwrite
+ * @param row Feedback row of the guess, indexed by wordList index
+ * @param code Observed feedback code
+ * @param size Number of dictionary words
+ */
+void candidates_select(CandidateSet* set, const uint8_t* row, uint8_t code, int size);
+
+/**
+ * Counts candidates per feedback code of a guess
+ * @param set Candidates
+ * @param row Feedback row of the guess, indexed by wordList index
+ * @param counts Output array of PATTERN_COUNT counts
+ */
+void candidates_histogram(const CandidateSet* set, const uint8_t* row,
+                          int counts[PATTERN_COUNT]);
+
+/**
+ * Hashes the members of a set two independent ways
+ * Equal sets give equal keys; the pair is used as the identity of a set.
+ * @param set Set to hash
+ * @param key1 Output, first hash
+ * @param key2 Output, second hash
+ */
+void candidates_hash(const CandidateSet* set, uint64_t* key1, uint64_t* key2);
+
+#endif
@@ -0,0 +1,96 @@
+/**
+ * columns.c - Position-major letter view of the dictionary
+ *
+ * All columns live in one cache-line aligned allocation, each padded to
+ * whole COLUMN_BLOCK blocks. Block scans work lane-wise over fixed-size
+ * arrays without branches, which the compiler turns into vector code.
+ */
+
+#include "columns.h"
+#include <stdlib.h>
+#include <string.h>
+
+// ============= Global Variables =============
+static WordColumns view;
+static void* arena = NULL;
+
+// ============= Column Functions =============
+
+bool columns_build(void) {
+    columns_free();
+    int blocks = (wordCount + COLUMN_BLOCK - 1) / COLUMN_BLOCK;
+    size_t padded = (size_t)(blocks > 0 ? blocks : 1) * COLUMN_BLOCK;
+    size_t bytes = padded * (WORD_LENGTH + ALPHABET_SIZE + sizeof(uint32_t));
+    arena = aligned_alloc(COLUMN_BLOCK, bytes);
+    if (!arena) return false;
+    memset(arena, 0, bytes);
+
+    uint8_t* next = (uint8_t*)arena;
+    view.presence = (uint32_t*)next;
+    next += padded * sizeof(uint32_t);
+    for (int i = 0; i < WORD_LENGTH; i++) {
+        view.letter[i] = next;
+        next += padded;
+    }
+    for (int l = 0; l < ALPHABET_SIZE; l++) {
+        view.count[l] = next;
+        next += padded;
+    }
+
+    for (int w = 0; w < wordCount; w++) {
+        if (wordPacked[w] == PACKED_INVALID) continue;   // Not a word: matches nothing
+        for (int i = 0; i < WORD_LENGTH; i++) {
+            uint8_t letter = (uint8_t)wordList[w][i];
+            view.letter[i][w] = letter;
+            view.presence[w] |= LETTER_BIT(letter);
+            view.count[letter - 'A'][w]++;
+        }
+    }
+    view.size = wordCount;
+    view.blocks = blocks;
+    return true;
+}
+
+const WordColumns* columns_get(void) {
+    return &view;
+}
+
+void columns_mask_all(LetterMask* mask) {
+    for (int i = 0; i < WORD_LENGTH; i++) {
+        mask->allowed[i] = (1u << ALPHABET_SIZE) - 1;
+    }
+    mask->required = 0;
+}
+
+/**
+ * Tests a block lane by lane
+ * A padding letter (0) maps to bit 31, which no mask allows.
+ */
+uint64_t columns_match(int block, const LetterMask* mask) {
+    size_t base = (size_t)block * COLUMN_BLOCK;
+    uint8_t hit[COLUMN_BLOCK];
+
+    const uint32_t* presence = view.presence + base;
+    for (int k = 0; k < COLUMN_BLOCK; k++) {
+        hit[k] = (presence[k] & mask->required) == mask->required;
+    }
+    for (int i = 0; i < WORD_LENGTH; i++) {
+        const uint8_t* column = view.letter[i] + base;
+        uint32_t allowed = mask->allowed[i] & ((1u << ALPHABET_SIZE) - 1);
+        for (int k = 0; k < COLUMN_BLOCK; k++) {
+            hit[k] &= (uint8_t)((allowed >> ((column[k] - 'A') & 31)) & 1);
+        }
+    }
+
+    uint64_t bits = 0;
+    for (int k = 0; k < COLUMN_BLOCK; k++) {
+        bits |= (uint64_t)hit[k] << k;
+    }
+    return bits;
+}
+
+void columns_free(void) {
+    free(arena);
+    arena = NULL;
+    memset(&view, 0, sizeof(view));
+}
@@ -0,0 +1,81 @@
+/**
+ * columns.h - Position-major letter view of the dictionary
+ *
+ * wordList stores each word as a 6-byte row, so a scan of one letter
+ * position strides through memory. This view, built by loadWords(),
+ * keeps the same words as struct-of-arrays columns instead: one byte
+ * column per letter position, a letter-presence mask per word and one
+ * column of letter counts per alphabet letter. Scans read each column
+ * sequentially, COLUMN_BLOCK words at a time, and a block lines up with
+ * one 64-bit block of a CandidateSet, so block results apply to
+ * candidate sets directly.
+ */
+
+#ifndef COLUMNS_H
+#define COLUMNS_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "wordle.h"
+
+// ============= Constants =============
+#define ALPHABET_SIZE 26
+#define COLUMN_BLOCK 64      // Words per scan block, one CandidateSet block
+#define LETTER_BIT(c) (1u << ((c) - 'A'))   // Presence bit of an upper case letter
+
+/**
+ * The dictionary as columns; word w is at index w of every column
+ * Columns are padded with zeros to whole blocks, so a scan may read a
+ * full last block; padding letters match no letter and have no counts.
+ */
+typedef struct {
+    uint8_t* letter[WORD_LENGTH];    // Upper case letter at each position
+    uint32_t* presence;              // Bit l set if letter 'A' + l occurs
+    uint8_t* count[ALPHABET_SIZE];   // Occurrences of letter 'A' + l in each word
+    int size;                        // Words (wordCount when built)
+    int blocks;                      // COLUMN_BLOCK blocks covering size
+} WordColumns;
+
+/**
+ * Letter constraints tested block by block with columns_match()
+ */
+typedef struct {
+    uint32_t allowed[WORD_LENGTH];   // Letters allowed at each position
+    uint32_t required;               // Letters that must occur
+} LetterMask;
+
+// ============= Column Functions =============
+
+/**
+ * Rebuilds the view for the loaded wordList
+ * Called by loadWords(); not safe while other threads scan.
+ * @return false on allocation failure (the view is then empty)
+ */
+bool columns_build(void);
+
+/**
+ * The view of the loaded wordList
+ * @return View with size 0 until columns_build() succeeds
+ */
+const WordColumns* columns_get(void);
+
+/**
+ * Starts a letter mask that every word matches
+ * @param mask Mask to reset
+ */
+void columns_mask_all(LetterMask* mask);
+
+/**
+ * Tests one block of words against a letter mask
+ * @param block Block number in [0, blocks)
+ * @param mask Letters allowed per position and required anywhere
+ * @return Bit k set if word block * COLUMN_BLOCK + k matches (never for padding)
+ */
+uint64_t columns_match(int block, const LetterMask* mask);
+
+/**
+ * Releases the view
+ */
+void columns_free(void);
+
+#endif
@@ -0,0 +1,172 @@
+/**
+ * evaluate.c - Whole-strategy evaluation by walking its decisions
+ *
+ * The walk mirrors the test harness round for round: an illegal or
+ * missing guess uses up a round and is reported as PATTERN_INVALID,
+ * which the players do not observe, so the strategy moves again from
+ * the same state; a solution not found within MAX_ROUNDS fails.
+ * When a tree is wanted, each state the walk reaches becomes a node;
+ * skipped rounds have no tree form, so the states below them are walked
+ * for the statistics but add no nodes.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include "evaluate.h"
+#include "feedback.h"
+
+/**
+ * State shared by the whole walk
+ */
+typedef struct {
+    Evaluation* eval;
+    const int* answer_index;   // wordList index of each solution, -1 if not in it
+    DecisionTree* tree;        // Tree being compiled, NULL for statistics only
+    bool failed;               // An allocation failed
+} Walk;
+
+// ============= Walk =============
+
+/**
+ * Records solutions found with a given number of guesses
+ */
+static void record_solved(Walk* w, const int* set, int count, int guesses) {
+    Evaluation* eval = w->eval;
+    for (int i = 0; i < count; i++) {
+        eval->guesses[set[i]] = guesses;
+    }
+    eval->solved += count;
+    eval->total_guesses += (long)guesses * count;
+    eval->distribution[guesses] += count;
+    if (guesses > eval->worst) eval->worst = guesses;
+}
+
+/**
+ * Feedback code of a solution for a dictionary guess
+ */
+static uint8_t answer_code(const Walk* w, const uint8_t* row, const char* guess, int answer) {
+    int index = w->answer_index[answer];
+    return index >= 0 ? row[index] : checkWordCode(solutionList[answer], guess);
+}
+
+/**
+ * Plays one game state for every solution still consistent with it
+ * @param ctx State before the round (modified)
+ * @param set solutionList indices reaching this state
+ * @param round Rounds played so far
+ * @param record Add nodes to w->tree (false below a skipped round)
+ * @return Tree node of the state, TREE_NONE if there is none
+ */
+static int walk(Walk* w, SolverContext* ctx, const int* set, int count, int round, bool record) {
+    if (round == MAX_ROUNDS || w->failed) return TREE_NONE;
+
+    const char* next = solver_next_guess(ctx);
+    w->eval->states++;
+    int guess_index = next ? word_index(next) : -1;
+    if (guess_index < 0) {
+        // The harness skips the round; the rejected guess is not observed
+        walk(w, ctx, set, count, round + 1, false);
+        return TREE_NONE;
+    }
+
+    char guess[WORD_LENGTH + 1];
+    strcpy(guess, next);
+    int* buckets = (int*)malloc(count * sizeof(int));
+    SolverContext* child = (SolverContext*)malloc(sizeof(SolverContext));
+    if (!buckets || !child) {
+        free(buckets);
+        free(child);
+        w->failed = true;
+        return TREE_NONE;
+    }
+
+    // Counting sort of the solutions by feedback
+    uint8_t scratch[MAX_WORDS];
+    const uint8_t* row = feedback_scan(guess_index, scratch);
+    int offsets[PATTERN_COUNT + 1];
+    int fill[PATTERN_COUNT] = {0};
+    for (int i = 0; i < count; i++) {
+        fill[answer_code(w, row, guess, set[i])]++;
+    }
+    offsets[0] = 0;
+    for (int c = 0; c < PATTERN_COUNT; c++) {
+        offsets[c + 1] = offsets[c] + fill[c];
+        fill[c] = offsets[c];
+    }
+    for (int i = 0; i < count; i++) {
+        buckets[fill[answer_code(w, row, guess, set[i])]++] = set[i];
+    }
+
+    int node = TREE_NONE;
+    if (w->tree && record) {
+        bool solves = offsets[PATTERN_WIN + 1] > offsets[PATTERN_WIN];
+        node = tree_add_node(w->tree, packWord(guess) | (solves ? TREE_SOLVES : 0));
+        if (node == TREE_NONE) w->failed = true;
+    }
+
+    for (int code = 0; code < PATTERN_COUNT && !w->failed; code++) {
+        int size = offsets[code + 1] - offsets[code];
+        if (size == 0) continue;
+        if (code == PATTERN_WIN) {
+            record_solved(w, buckets + offsets[code], size, round + 1);
+            continue;
+        }
+        *child = *ctx;
+        solver_observe(child, guess, (uint8_t)code);
+        int next_node = walk(w, child, buckets + offsets[code], size, round + 1, record);
+        if (node != TREE_NONE && next_node != TREE_NONE &&
+            !tree_set_child(w->tree, node, (uint8_t)code, next_node)) {
+            w->failed = true;
+        }
+    }
+
+    free(child);
+    free(buckets);
+    return node;
+}
+
+// ============= Evaluation Functions =============
+
+bool evaluate_strategy(Strategy strategy, Evaluation* eval) {
+    return compile_strategy(strategy, NULL, eval);
+}
+
+bool compile_strategy(Strategy strategy, DecisionTree* tree, Evaluation* eval) {
+    memset(eval, 0, sizeof(*eval));
+    if (tree) {
+        memset(tree, 0, sizeof(*tree));
+    }
+    eval->answers = solutionCount;
+    eval->guesses = (int*)calloc(solutionCount > 0 ? solutionCount : 1, sizeof(int));
+    int* answer_index = (int*)malloc((solutionCount > 0 ? solutionCount : 1) * sizeof(int));
+    int* set = (int*)malloc((solutionCount > 0 ? solutionCount : 1) * sizeof(int));
+    SolverContext* ctx = solver_create(strategy);
+    bool ok = eval->guesses && answer_index && set && ctx;
+
+    if (ok) {
+        feedback_init();
+        for (int i = 0; i < solutionCount; i++) {
+            answer_index[i] = dictionary_find(solutionPacked[i]);
+            set[i] = i;
+        }
+        Walk w = { eval, answer_index, tree, false };
+        int root = walk(&w, ctx, set, solutionCount, 0, true);
+        ok = !w.failed && (!tree || root == TREE_ROOT);
+    }
+
+    solver_destroy(ctx);
+    free(set);
+    free(answer_index);
+    if (!ok) {
+        evaluation_free(eval);
+        if (tree) {
+            tree_free(tree);
+        }
+    }
+    return ok;
+}
+
+void evaluation_free(Evaluation* eval) {
+    free(eval->guesses);
+    eval->guesses = NULL;
+}
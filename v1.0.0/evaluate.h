@@ -0,0 +1,64 @@
+/**
+ * evaluate.h - Whole-strategy evaluation by walking its decisions
+ *
+ * Instead of replaying one game per solution, the strategy is asked for
+ * its move once per game state: the solutions still consistent with a
+ * state are split by the feedback of that move and each bucket continues
+ * from a copy of the context. Every state is computed once, and the
+ * result is exactly what playing every solution separately would give,
+ * for any deterministic strategy. The same walk can record the moves as
+ * a decision tree, turning a searching strategy into a lookup table.
+ */
+
+#ifndef EVALUATE_H
+#define EVALUATE_H
+
+#include <stdbool.h>
+#include "wordle.h"
+#include "solver.h"
+#include "tree.h"
+
+/**
+ * Outcome of every solution under one strategy
+ */
+typedef struct {
+    int* guesses;                        // Per solutionList entry: guesses used, 0 if failed
+    int answers;                         // Solutions played (solutionCount)
+    int solved;                          // Solutions found within MAX_ROUNDS
+    long total_guesses;                  // Sum over the solved solutions
+    int worst;                           // Most guesses needed by a solved solution
+    int distribution[MAX_ROUNDS + 1];    // Solved solutions by guesses used
+    int states;                          // Game states the strategy was asked about
+} Evaluation;
+
+// ============= Evaluation Functions =============
+
+/**
+ * Plays every solution with a strategy, walking its decisions
+ * Runs with a quiet context; the strategy's own scans still use the pool.
+ * @param strategy Strategy to evaluate
+ * @param eval Output (free with evaluation_free)
+ * @return true on success, false on allocation failure
+ */
+bool evaluate_strategy(Strategy strategy, Evaluation* eval);
+
+/**
+ * Plays every solution with a strategy and records its moves as a tree
+ * The tree has one node per game state, so a player following it makes
+ * the same guesses as the strategy for every solution. Guesses the
+ * strategy failed to make (NULL or not in wordList) are left off the tree.
+ * @param strategy Strategy to compile
+ * @param tree Output tree (overwritten; free with tree_free), NULL to only evaluate
+ * @param eval Output (free with evaluation_free)
+ * @return true on success; false on allocation failure or if the strategy
+ *         has no legal first guess
+ */
+bool compile_strategy(Strategy strategy, DecisionTree* tree, Evaluation* eval);
+
+/**
+ * Frees the per-solution results
+ * @param eval Evaluation to free
+ */
+void evaluation_free(Evaluation* eval);
+
+#endif
@@ -0,0 +1,359 @@
+/**
+ * feedback.c - Precomputed guess x answer feedback matrix
+ *
+ * Builds a dense table of feedback codes for every pair of dictionary
+ * words. The table is filled on the worker pool, one interleaved set of
+ * rows per worker, and is then read-only for the rest of the process.
+ *
+ * Codes are produced by a batch kernel that scores one guess against a
+ * block of answers held position-major (one column of letters per
+ * position), with the duplicate-letter rule done by lane-wise counting
+ * instead of branches. It is compiled for AVX2, SSE4.2 and a baseline
+ * target and picked at load time.
+ *
+ * The table is also kept on disk (FEEDBACK_CACHE_FILE). When the cache
+ * header matches the loaded wordList it is mapped read-only, so every
+ * solver process on a machine shares one page-cache copy.
+ */
+
+#include "feedback.h"
+#include "columns.h"
+#include "pool.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+// ============= Constants =============
+#define CACHE_MAGIC "WFBMTRX"     // 8 bytes including the terminator
+#define CACHE_VERSION 2
+#define CACHE_HEADER_SIZE 4096    // Keeps the table page aligned
+
+/**
+ * On-disk cache header, followed by the table at CACHE_HEADER_SIZE
+ */
+typedef struct {
+    char magic[8];
+    uint32_t version;
+    uint32_t word_length;
+    uint32_t guess_count;     // Rows
+    uint32_t answer_count;    // Columns
+    uint64_t words_hash;      // Hash of the loaded wordList
+} CacheHeader;
+
+// ============= Global Variables =============
+static uint8_t* matrix = NULL;   // wordCount x wordCount codes, row = guess
+static int matrix_size = 0;      // Number of words the matrix was built for
+static void* mapping = NULL;     // Cache mapping when the matrix is mmapped
+static size_t mapping_length = 0;
+
+// ============= Batch Kernel =============
+
+#if defined(__GNUC__) && !defined(__clang__) && defined(__x86_64__) && defined(__linux__)
+#define KERNEL_CLONES __attribute__((target_clones("avx2", "sse4.2", "default")))
+#else
+#define KERNEL_CLONES
+#endif
+
+#ifdef __GNUC__
+#define KERNEL_LANES 32
+typedef uint8_t LaneBytes __attribute__((vector_size(KERNEL_LANES)));
+
+/**
+ * Scores one guess against KERNEL_LANES answers
+ * Every lane follows checkWordCode(): a guess letter is yellow when fewer
+ * earlier non-green copies of it exist in the guess than unmatched
+ * copies remain in the answer.
+ */
+static inline __attribute__((always_inline))
+void score_lanes(const char* guess, const LaneBytes letters[WORD_LENGTH], LaneBytes* codes) {
+    LaneBytes green[WORD_LENGTH];
+    for (int i = 0; i < WORD_LENGTH; i++) {
+        green[i] = (LaneBytes)(letters[i] == (uint8_t)guess[i]);   // 0xFF or 0
+    }
+
+    LaneBytes code = {0};
+    for (int i = 0; i < WORD_LENGTH; i++) {
+        uint8_t letter = (uint8_t)guess[i];
+
+        // Copies of the letter in the answer not already taken by a green
+        LaneBytes available = {0};
+        for (int j = 0; j < WORD_LENGTH; j++) {
+            available -= (LaneBytes)(letters[j] == letter);
+            if ((uint8_t)guess[j] == letter) {
+                available += green[j];
+            }
+        }
+
+        // Earlier non-green copies of the letter in the guess
+        LaneBytes earlier = {0};
+        for (int k = 0; k < i; k++) {
+            if ((uint8_t)guess[k] == letter) {
+                earlier -= ~green[k];
+            }
+        }
+
+        LaneBytes yellow = (LaneBytes)(earlier < available) & ~green[i];
+        code = code + code + code + ((green[i] & 2) | (yellow & 1));
+    }
+    *codes = code;
+}
+#endif
+
+/**
+ * Computes feedback codes for one guess against a block of answers
+ */
+KERNEL_CLONES
+void feedback_batch(const char guess[WORD_LENGTH + 1],
+                    const uint8_t* const columns[WORD_LENGTH],
+                    int count, uint8_t* codes) {
+    int a = 0;
+#ifdef __GNUC__
+    LaneBytes letters[WORD_LENGTH];
+    for (; a + KERNEL_LANES <= count; a += KERNEL_LANES) {
+        for (int i = 0; i < WORD_LENGTH; i++) {
+            memcpy(&letters[i], columns[i] + a, KERNEL_LANES);
+        }
+        LaneBytes block;
+        score_lanes(guess, letters, &block);
+        memcpy(codes + a, &block, KERNEL_LANES);
+    }
+    if (a < count) {
+        // Partial last block: zero letters never match a guess letter
+        int rest = count - a;
+        memset(letters, 0, sizeof(letters));
+        for (int i = 0; i < WORD_LENGTH; i++) {
+            memcpy(&letters[i], columns[i] + a, rest);
+        }
+        LaneBytes block;
+        score_lanes(guess, letters, &block);
+        memcpy(codes + a, &block, rest);
+    }
+#else
+    char answer[WORD_LENGTH + 1] = {0};
+    for (; a < count; a++) {
+        for (int i = 0; i < WORD_LENGTH; i++) {
+            answer[i] = (char)columns[i][a];
+        }
+        codes[a] = checkWordCode(answer, guess);
+    }
+#endif
+}
+
+/**
+ * Letter columns of the dictionary for the kernel (columns.h)
+ * @return NULL if the view does not cover the loaded wordList
+ */
+static const uint8_t* const* answer_columns(void) {
+    const WordColumns* view = columns_get();
+    return view->size == wordCount && wordCount > 0 ? (const uint8_t* const*)view->letter : NULL;
+}
+
+// ============= Matrix Build =============
+
+/**
+ * Fills every row assigned to one pool worker
+ * @param arg Letter columns of the answers
+ */
+static void build_rows(void* arg, int worker, int workers) {
+    for (int g = worker; g < matrix_size; g += workers) {
+        feedback_batch(wordList[g], (const uint8_t* const*)arg, matrix_size,
+                       matrix + (size_t)g * matrix_size);
+    }
+}
+
+// ============= Cache File =============
+
+/**
+ * Fills in the header describing the currently loaded wordList
+ */
+static void make_header(CacheHeader* header) {
+    memset(header, 0, sizeof(*header));
+    memcpy(header->magic, CACHE_MAGIC, sizeof(header->magic));
+    header->version = CACHE_VERSION;
+    header->word_length = WORD_LENGTH;
+    header->guess_count = (uint32_t)wordCount;
+    header->answer_count = (uint32_t)wordCount;
+    header->words_hash = hashWords(wordList, wordCount);
+}
+
+/**
+ * Maps a cache file whose header matches the loaded wordList
+ * @return true if the matrix now points into the mapping
+ */
+static bool map_cache(void) {
+    int fd = open(FEEDBACK_CACHE_FILE, O_RDONLY);
+    if (fd < 0) return false;
+
+    CacheHeader expected, found;
+    make_header(&expected);
+    size_t length = CACHE_HEADER_SIZE + (size_t)wordCount * wordCount;
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || (size_t)st.st_size != length ||
+        read(fd, &found, sizeof(found)) != (ssize_t)sizeof(found) ||
+        memcmp(&found, &expected, sizeof(found)) != 0) {
+        close(fd);
+        return false;
+    }
+
+    void* base = mmap(NULL, length, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (base == MAP_FAILED) return false;
+
+#ifdef MADV_HUGEPAGE
+    // Only honoured where the kernel supports huge pages for file mappings
+    madvise(base, length, MADV_HUGEPAGE);
+#endif
+    madvise(base, length, MADV_WILLNEED);
+
+    mapping = base;
+    mapping_length = length;
+    matrix = (uint8_t*)base + CACHE_HEADER_SIZE;
+    matrix_size = wordCount;
+    return true;
+}
+
+/**
+ * Writes the in-memory matrix to the cache file
+ * Goes through a temporary file so readers never see a partial cache.
+ */
+static bool write_cache(void) {
+    char temp_name[256];
+    snprintf(temp_name, sizeof(temp_name), "%s.%ld.tmp", FEEDBACK_CACHE_FILE, (long)getpid());
+
+    FILE* file = fopen(temp_name, "wb");
+    if (!file) return false;
+
+    char header_block[CACHE_HEADER_SIZE] = {0};
+    CacheHeader header;
+    make_header(&header);
+    memcpy(header_block, &header, sizeof(header));
+
+    size_t length = (size_t)matrix_size * matrix_size;
+    bool ok = fwrite(header_block, 1, sizeof(header_block), file) == sizeof(header_block) &&
+              fwrite(matrix, 1, length, file) == length;
+    ok = (fclose(file) == 0) && ok;
+    if (!ok || rename(temp_name, FEEDBACK_CACHE_FILE) != 0) {
+        remove(temp_name);
+        return false;
+    }
+    return true;
+}
+
+/**
+ * Attaches a matching cache once wordList is loaded
+ */
+bool feedback_attach_cache(void) {
+    if (matrix) return true;
+    if (wordCount == 0) return false;
+    if (!map_cache()) return false;
+    printf("Mapped %d x %d feedback matrix from %s\n",
+           matrix_size, matrix_size, FEEDBACK_CACHE_FILE);
+    return true;
+}
+
+// ============= Matrix Functions =============
+
+/**
+ * Builds the matrix over the loaded dictionary using all online cores
+ * A matching cache file is used instead when present; otherwise the
+ * freshly built table is saved and remapped from the cache.
+ */
+bool feedback_init(void) {
+    if (matrix) return true;
+    if (wordCount == 0) return false;
+    if (feedback_attach_cache()) return true;
+    const uint8_t* const* columns = answer_columns();
+    if (!columns) return false;
+
+    matrix = (uint8_t*)malloc((size_t)wordCount * wordCount);
+    if (!matrix) {
+        printf("Failed to allocate feedback matrix\n");
+        return false;
+    }
+    matrix_size = wordCount;
+
+    pool_run(build_rows, (void*)columns);
+    printf("Built %d x %d feedback matrix with %d threads\n",
+           matrix_size, matrix_size, pool_size());
+
+    // Swap the private copy for the shared mapping of what was just written
+    if (write_cache()) {
+        uint8_t* built = matrix;
+        matrix = NULL;
+        if (map_cache()) {
+            free(built);
+        } else {
+            matrix = built;
+        }
+    }
+    return true;
+}
+
+bool feedback_ready(void) {
+    return matrix != NULL;
+}
+
+const uint8_t* feedback_row(int guess) {
+    return matrix + (size_t)guess * matrix_size;
+}
+
+/**
+ * Matrix row when built, otherwise the row computed on the fly
+ */
+const uint8_t* feedback_scan(int guess, uint8_t* scratch) {
+    if (matrix) {
+        return feedback_row(guess);
+    }
+    const uint8_t* const* columns = answer_columns();
+    if (!columns) {
+        for (int a = 0; a < wordCount; a++) {
+            scratch[a] = checkWordCode(wordList[a], wordList[guess]);
+        }
+        return scratch;
+    }
+    feedback_batch(wordList[guess], columns, wordCount, scratch);
+    return scratch;
+}
+
+uint8_t feedback_get(int guess, int answer) {
+    return matrix[(size_t)guess * matrix_size + answer];
+}
+
+/**
+ * Feedback code for any pair, served from the matrix when possible
+ */
+uint8_t feedback_code(const char solution[WORD_LENGTH + 1],
+                      const char guess[WORD_LENGTH + 1]) {
+    if (matrix) {
+        int g = word_index(guess);
+        int a = g < 0 ? -1 : word_index(solution);
+        if (a >= 0) {
+            return feedback_get(g, a);
+        }
+    }
+    return checkWordCode(solution, guess);
+}
+
+/**
+ * Dictionary lookup through the hash index, canonical spelling only
+ */
+int word_index(const char* word) {
+    return dictionary_find(packCanonical(word));
+}
+
+void feedback_free(void) {
+    if (mapping) {
+        munmap(mapping, mapping_length);
+        mapping = NULL;
+        mapping_length = 0;
+    } else {
+        free(matrix);
+    }
+    matrix = NULL;
+    matrix_size = 0;
+}
@@ -0,0 +1,104 @@
+/**
+ * feedback.h - Precomputed feedback matrix shared by all strategies
+ *
+ * Every strategy needs the feedback of many (guess, candidate) pairs on
+ * every move. This module computes the whole guess x answer table once,
+ * as base-3 codes in one byte each, so the hot loops become table lookups.
+ *
+ * The table is cached on disk and memory-mapped by later processes whose
+ * wordList hashes to the same value; solutionList plays no part in it.
+ *
+ * Codes use the layout of checkWordCode() in wordle.h.
+ */
+
+#ifndef FEEDBACK_H
+#define FEEDBACK_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "wordle.h"
+
+// ============= Constants =============
+#define FEEDBACK_CACHE_FILE "feedback.cache"  // On-disk copy of the matrix
+
+// ============= Matrix Functions =============
+
+/**
+ * Builds the feedback matrix for the loaded dictionary (idempotent)
+ * Rows are guesses from wordList, columns are answers from wordList.
+ * @return true if the matrix is available afterwards
+ */
+bool feedback_init(void);
+
+/**
+ * Maps a cached matrix matching the loaded wordList
+ * Called by loadWords(); does nothing until wordList is loaded.
+ * @return true if the matrix is available afterwards
+ */
+bool feedback_attach_cache(void);
+
+/**
+ * Reports whether the matrix has been built
+ * @return true if feedback_get/feedback_row may be used
+ */
+bool feedback_ready(void);
+
+/**
+ * Returns the row of codes for one guess against every answer
+ * @param guess Index of the guess in wordList
+ * @return Pointer to wordCount codes, indexed by answer
+ */
+const uint8_t* feedback_row(int guess);
+
+/**
+ * Returns the row for one guess, computing it when there is no matrix
+ * @param guess Index of the guess in wordList
+ * @param scratch Buffer of at least wordCount bytes used without a matrix
+ * @return Pointer to wordCount codes, either the matrix row or scratch
+ */
+const uint8_t* feedback_scan(int guess, uint8_t* scratch);
+
+/**
+ * Computes feedback codes for one guess against a block of answers
+ * Vectorized (AVX2/SSE4.2 where available) over position-major input.
+ * @param guess Guessed word
+ * @param columns WORD_LENGTH arrays of answer letters, one per position
+ * @param count Number of answers
+ * @param codes Output, one code per answer
+ */
+void feedback_batch(const char guess[WORD_LENGTH + 1],
+                    const uint8_t* const columns[WORD_LENGTH],
+                    int count, uint8_t* codes);
+
+/**
+ * Looks up a single feedback code
+ * @param guess Index of the guess in wordList
+ * @param answer Index of the answer in wordList
+ * @return Feedback code (0-242)
+ */
+uint8_t feedback_get(int guess, int answer);
+
+/**
+ * Feedback code for an arbitrary pair of words
+ * Uses the matrix when both words are in the dictionary and it is built,
+ * otherwise computes the code directly.
+ * @param solution Target word
+ * @param guess Guessed word
+ * @return Feedback code (0-242)
+ */
+uint8_t feedback_code(const char solution[WORD_LENGTH + 1],
+                      const char guess[WORD_LENGTH + 1]);
+
+/**
+ * Finds a word's index in wordList
+ * @param word Uppercase word
+ * @return Index, or -1 if the word is not in the dictionary
+ */
+int word_index(const char* word);
+
+/**
+ * Releases the matrix
+ */
+void feedback_free(void);
+
+#endif
@@ -0,0 +1,169 @@
+/**
+ * knowledge.c - Accumulated feedback constraints and constraint filtering
+ *
+ * One round of feedback says, for each guessed letter L:
+ *   - a green position holds L, any other position does not hold that
+ *     guess letter (it would have been green)
+ *   - the answer has at least as many copies of L as there are green
+ *     and yellow L's, and exactly that many if some L is black
+ * checkWordCode() marks the earliest non-green copies yellow, so a
+ * yellow L after a black L never occurs and is treated as a contradiction.
+ * Together these are exactly the words giving that feedback.
+ */
+
+#include "knowledge.h"
+#include <string.h>
+
+// ============= Knowledge Functions =============
+
+void knowledge_init(Knowledge* knowledge) {
+    columns_mask_all(&knowledge->letters);
+    memset(knowledge->min_count, 0, sizeof(knowledge->min_count));
+    memset(knowledge->max_count, WORD_LENGTH, sizeof(knowledge->max_count));
+    knowledge->impossible = false;
+}
+
+bool knowledge_add(Knowledge* knowledge, const char guess[WORD_LENGTH + 1], uint8_t code) {
+    if (code >= PATTERN_COUNT || packCanonical(guess) == PACKED_INVALID) return false;
+
+    uint8_t digits[WORD_LENGTH];
+    for (int i = WORD_LENGTH - 1; i >= 0; i--) {
+        digits[i] = code % 3;
+        code /= 3;
+    }
+
+    LetterMask* letters = &knowledge->letters;
+    int found[ALPHABET_SIZE] = {0};        // Green and yellow copies
+    bool exhausted[ALPHABET_SIZE] = {0};   // A black copy: no more in the answer
+    uint32_t guessed = 0;
+    for (int i = 0; i < WORD_LENGTH; i++) {
+        int l = guess[i] - 'A';
+        uint32_t bit = 1u << l;
+        guessed |= bit;
+        if (digits[i] == 2) {
+            if (!(letters->allowed[i] & bit)) knowledge->impossible = true;
+            letters->allowed[i] = bit;
+            found[l]++;
+            continue;
+        }
+        letters->allowed[i] &= ~bit;
+        if (digits[i] == 1) {
+            if (exhausted[l]) knowledge->impossible = true;   // Never produced
+            found[l]++;
+        } else {
+            exhausted[l] = true;
+        }
+    }
+
+    for (int l = 0; l < ALPHABET_SIZE; l++) {
+        if (!(guessed & (1u << l))) continue;
+        if (found[l] > knowledge->min_count[l]) knowledge->min_count[l] = (uint8_t)found[l];
+        if (exhausted[l] && found[l] < knowledge->max_count[l]) {
+            knowledge->max_count[l] = (uint8_t)found[l];
+        }
+        if (knowledge->min_count[l] > knowledge->max_count[l]) knowledge->impossible = true;
+        if (knowledge->min_count[l] > 0) letters->required |= 1u << l;
+        if (knowledge->max_count[l] == 0) {
+            for (int i = 0; i < WORD_LENGTH; i++) {
+                letters->allowed[i] &= ~(1u << l);
+            }
+        }
+    }
+
+    int least = 0;
+    for (int l = 0; l < ALPHABET_SIZE; l++) {
+        least += knowledge->min_count[l];
+    }
+    for (int i = 0; i < WORD_LENGTH; i++) {
+        if (!letters->allowed[i]) knowledge->impossible = true;
+    }
+    if (least > WORD_LENGTH) knowledge->impossible = true;
+    return true;
+}
+
+bool knowledge_from_history(Knowledge* knowledge, const char (*guesses)[WORD_LENGTH + 1],
+                            const uint8_t* codes, int rounds) {
+    knowledge_init(knowledge);
+    for (int r = 0; r < rounds; r++) {
+        if (!knowledge_add(knowledge, guesses[r], codes[r])) return false;
+    }
+    return true;
+}
+
+bool knowledge_allows(const Knowledge* knowledge, const char word[WORD_LENGTH + 1]) {
+    if (knowledge->impossible || packCanonical(word) == PACKED_INVALID) return false;
+    uint8_t count[ALPHABET_SIZE] = {0};
+    for (int i = 0; i < WORD_LENGTH; i++) {
+        int l = word[i] - 'A';
+        if (!(knowledge->letters.allowed[i] & (1u << l))) return false;
+        count[l]++;
+    }
+    for (int l = 0; l < ALPHABET_SIZE; l++) {
+        if (count[l] < knowledge->min_count[l] || count[l] > knowledge->max_count[l]) return false;
+    }
+    return true;
+}
+
+/**
+ * Letters whose count bounds the masks do not already enforce
+ * Masks cover "at least one" (required) and "none" (not allowed anywhere).
+ * @return Number of letters written to counted
+ */
+static int counted_letters(const Knowledge* knowledge, int counted[ALPHABET_SIZE]) {
+    int n = 0;
+    for (int l = 0; l < ALPHABET_SIZE; l++) {
+        if (knowledge->min_count[l] > 1 ||
+            (knowledge->max_count[l] > 0 && knowledge->max_count[l] < WORD_LENGTH)) {
+            counted[n++] = l;
+        }
+    }
+    return n;
+}
+
+/**
+ * Words of one block satisfying every constraint
+ */
+static uint64_t match_block(const Knowledge* knowledge, const WordColumns* view, int block,
+                            const int* counted, int n) {
+    uint64_t bits = columns_match(block, &knowledge->letters);
+    size_t base = (size_t)block * COLUMN_BLOCK;
+    for (int c = 0; c < n && bits; c++) {
+        const uint8_t* count = view->count[counted[c]] + base;
+        uint8_t low = knowledge->min_count[counted[c]], high = knowledge->max_count[counted[c]];
+        uint64_t within = 0;
+        for (int k = 0; k < COLUMN_BLOCK; k++) {
+            within |= (uint64_t)(count[k] >= low && count[k] <= high) << k;
+        }
+        bits &= within;
+    }
+    return bits;
+}
+
+void knowledge_filter(const Knowledge* knowledge, CandidateSet* set) {
+    const WordColumns* view = columns_get();
+    if (knowledge->impossible) {
+        candidates_clear(set);
+        return;
+    }
+    if (view->size != wordCount) {
+        // No column view: test the candidates one by one
+        for (int i = candidates_next(set, 0); i >= 0; i = candidates_next(set, i + 1)) {
+            if (!knowledge_allows(knowledge, wordList[i])) candidates_remove(set, i);
+        }
+        return;
+    }
+
+    int counted[ALPHABET_SIZE];
+    int n = counted_letters(knowledge, counted);
+    for (int b = 0; b < view->blocks && b < CANDIDATE_BLOCKS; b++) {
+        if (set->bits[b]) {
+            set->bits[b] &= match_block(knowledge, view, b, counted, n);
+        }
+    }
+    candidates_count(set);
+}
+
+void knowledge_select(const Knowledge* knowledge, CandidateSet* set) {
+    candidates_fill(set, wordCount);
+    knowledge_filter(knowledge, set);
+}
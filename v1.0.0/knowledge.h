@@ -0,0 +1,87 @@
+/**
+ * knowledge.h - What a game's feedback has revealed about the answer
+ *
+ * Every (guess, feedback) pair narrows the answer to words with certain
+ * letters at certain positions and a certain number of copies of each
+ * guessed letter. A Knowledge value accumulates these constraints as
+ * allowed-letter masks per position and minimum/maximum letter counts,
+ * so any number of rounds, in any order, reduce to one fixed-size value.
+ * Matching words are then found with bit operations over the letter
+ * columns (columns.h), in a single pass over the dictionary, without
+ * computing a single feedback code.
+ *
+ * A word satisfies the constraints of a round exactly when checkWordCode()
+ * would give it that round's feedback.
+ */
+
+#ifndef KNOWLEDGE_H
+#define KNOWLEDGE_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "wordle.h"
+#include "columns.h"
+#include "candidates.h"
+
+/**
+ * Constraints on the answer from the feedback seen so far
+ */
+typedef struct {
+    LetterMask letters;                  // Allowed letters per position, letters known to occur
+    uint8_t min_count[ALPHABET_SIZE];    // Fewest copies of each letter the answer can have
+    uint8_t max_count[ALPHABET_SIZE];    // Most copies of each letter the answer can have
+    bool impossible;                     // The feedback contradicts itself: nothing matches
+} Knowledge;
+
+// ============= Knowledge Functions =============
+
+/**
+ * Starts with no constraints
+ * @param knowledge State to reset
+ */
+void knowledge_init(Knowledge* knowledge);
+
+/**
+ * Adds the constraints of one round
+ * @param knowledge State to update
+ * @param guess Word played, WORD_LENGTH upper case letters
+ * @param code Feedback code received for it
+ * @return false (leaving the state unchanged) if the guess is not a word of
+ *         letters or the code is not a feedback code
+ */
+bool knowledge_add(Knowledge* knowledge, const char guess[WORD_LENGTH + 1], uint8_t code);
+
+/**
+ * Builds the state of a whole game history
+ * @param knowledge Output state
+ * @param guesses Words played, in any order
+ * @param codes Feedback received for each
+ * @param rounds Number of rounds
+ * @return false if a round could not be added (see knowledge_add)
+ */
+bool knowledge_from_history(Knowledge* knowledge, const char (*guesses)[WORD_LENGTH + 1],
+                            const uint8_t* codes, int rounds);
+
+/**
+ * Tests one word against the constraints
+ * @param knowledge Constraints
+ * @param word Word to test
+ * @return true if the word can still be the answer
+ */
+bool knowledge_allows(const Knowledge* knowledge, const char word[WORD_LENGTH + 1]);
+
+/**
+ * Keeps only the candidates that satisfy the constraints
+ * @param knowledge Constraints
+ * @param set Set of wordList indices to narrow
+ */
+void knowledge_filter(const Knowledge* knowledge, CandidateSet* set);
+
+/**
+ * Collects every dictionary word that satisfies the constraints
+ * @param knowledge Constraints
+ * @param set Output set (overwritten)
+ */
+void knowledge_select(const Knowledge* knowledge, CandidateSet* set);
+
+#endif
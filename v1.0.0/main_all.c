@@ -1,9 +1,14 @@
 #include "wordle.h"
 #include "player.h"
+#include "feedback.h"
 #include <stdio.h>
 #include <string.h>
 #include <stdbool.h>
 #include <ctype.h>
+#include "pool.h"
+#include "book.h"
+#include "evaluate.h"
+#include "solver.h"
 #include <time.h>
 #include <stdlib.h>
 typedef struct {
@@ -11,55 +16,141 @@ typedef struct {
     int score;
     int guesses;
 } TestResult;
-// 这个数组用来捕获每次调用 wordle 的最后一行输出（得分）
-int found_score = 0;
-int found_guesses = 0;
-// 重写一个简单版本的 wordle 函数
-void test_wordle(const char solution[WORD_LENGTH + 1], Player *player) {
+// 并行模式的共享状态：各线程从 next 领取下一个 solution
+typedef struct {
+    Player player;
+    TestResult* results;
+    int next;
+    Strategy strategy;   // 与 player 对应，困难模式下用来建每个线程的求解器状态
+    bool hard;
+} ParallelRun;
+// 墙钟时间（秒），并行时 clock() 会把所有线程的 CPU 时间加在一起
+static double now_seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+// 困难模式的求解器状态：作为每局的 state 交给 player；普通模式返回 NULL，player 用自己的线程状态
+static SolverContext* hard_context(Strategy strategy, bool hard) {
+    if (!hard) return NULL;
+    SolverContext* ctx = solver_create(strategy);
+    if (ctx) {
+        ctx->hard_mode = true;
+    }
+    return ctx;
+}
+// 重写一个简单版本的 wordle 函数，得分和猜测次数写入 result；state 原样交给 player
+void test_wordle(const char solution[WORD_LENGTH + 1], Player *player, void* state, TestResult* result) {
     if (wordCount == 0) {
         loadWords("wordList.txt");
     }
     if (solutionCount == 0) {
         loadSolution("solutionList.txt");
     }
+    result->score = 0;
+    result->guesses = 0;
     if (invalid(solution)) {
         return;
     }
     
-    char* lastResult = (char*)malloc(WORD_LENGTH * sizeof(char));
-    for (int i = 0; i < WORD_LENGTH; i++) {
-        lastResult[i] = ' ';
-    }
-    lastResult[WORD_LENGTH] = '\0';
+    uint8_t lastCode = PATTERN_NONE;
+    char guess[WORD_LENGTH + 1];
     
     int i;
     for (i = 0; i < MAX_ROUNDS; i++) {
-        char* guess = (*player)(lastResult);
-        if (not_legal(guess)) {
-            free(guess);
+        if (!(*player)(state, lastCode, guess) || not_legal(guess)) {
+            lastCode = PATTERN_INVALID;
             continue;
         }
         
-        char* result = checkWord(solution, guess);
-        if (strcmp(solution, guess) == 0) {
-            found_score = 10 - i;
-            found_guesses = i + 1;
-            free(guess);
-            free(result);
-            free(lastResult);
+        uint8_t code = feedback_code(solution, guess);
+        if (code == PATTERN_WIN) {
+            result->score = 10 - i;
+            result->guesses = i + 1;
             return;
         }
         
-        free(guess);
-        free(lastResult);
-        lastResult = result;
+        lastCode = code;
     }
     
-    found_score = 0;
-    found_guesses = MAX_ROUNDS;
-    free(lastResult);
+    result->score = 0;
+    result->guesses = MAX_ROUNDS;
+}
+// 像只收到历史记录的服务器那样下一局：每一步都用 solver_resume 从历史恢复局面再出招，
+// 并与逐步 solver_observe 的同一局比较，返回两者出招不一致的步数
+static int resume_game(Strategy strategy, bool hard, const char solution[WORD_LENGTH + 1],
+                       TestResult* result) {
+    static SolverContext sequential, resumed;
+    char guesses[MAX_ROUNDS][WORD_LENGTH + 1];
+    uint8_t codes[MAX_ROUNDS];
+    int mismatches = 0;
+    solver_init(&sequential, strategy);
+    solver_init(&resumed, strategy);
+    sequential.hard_mode = hard;
+    resumed.hard_mode = hard;
+    result->score = 0;
+    result->guesses = MAX_ROUNDS;
+    for (int i = 0; i < MAX_ROUNDS; i++) {
+        solver_resume(&resumed, guesses, codes, i);
+        const char* guess = solver_next_guess(&resumed);
+        const char* expected = solver_next_guess(&sequential);
+        if (!guess || !expected || strcmp(guess, expected) != 0) {
+            printf("Resume mismatch: %s round %d: %s, sequential %s\n", solution, i + 1,
+                   guess ? guess : "(none)", expected ? expected : "(none)");
+            mismatches++;
+        }
+        if (!guess) break;
+        
+        strcpy(guesses[i], guess);
+        codes[i] = checkWordCode(solution, guess);
+        if (codes[i] == PATTERN_WIN) {
+            result->score = 10 - i;
+            result->guesses = i + 1;
+            break;
+        }
+        solver_observe(&sequential, guess, codes[i]);
+    }
+    return mismatches;
+}
+// 线程池任务：每个线程用自己的（线程局部）求解器状态依次玩领到的题目
+static void parallel_worker(void* arg, int worker, int workers) {
+    ParallelRun* run = (ParallelRun*)arg;
+    (void)worker;
+    (void)workers;
+    SolverContext* state = hard_context(run->strategy, run->hard);
+    int i;
+    while ((i = __atomic_fetch_add(&run->next, 1, __ATOMIC_RELAXED)) < solutionCount) {
+        strcpy(run->results[i].word, solutionList[i]);
+        test_wordle(solutionList[i], &run->player, state, &run->results[i]);
+    }
+    solver_destroy(state);
 }
-int main() {
+int main(int argc, char** argv) {
+    // ./wordle_all --parallel 时把题目分给线程池（WORDLE_THREADS 控制线程数）
+    // --book 时先算好整本开局库（第二步猜测），之后每局第二步都是查表
+    // --walk 时不逐题重玩，而是沿策略的决策树遍历一次，每个局面只算一次
+    // --resume 时每一步都从历史记录恢复局面，并检查与逐步对局出招一致
+    // --tree 时测试决策树策略（player_AI）而不是熵策略
+    // --hard 时按困难模式下：已知的绿色字母必须留在原位，黄色字母必须用上
+    bool parallel = false;
+    bool build_book = false;
+    bool walk = false;
+    bool resume = false;
+    bool use_tree = false;
+    bool hard = false;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--parallel") == 0) parallel = true;
+        if (strcmp(argv[i], "--book") == 0) build_book = true;
+        if (strcmp(argv[i], "--walk") == 0) walk = true;
+        if (strcmp(argv[i], "--resume") == 0) resume = true;
+        if (strcmp(argv[i], "--tree") == 0) use_tree = true;
+        if (strcmp(argv[i], "--hard") == 0) hard = true;
+    }
+    if (hard && walk) {
+        fprintf(stderr, "--hard cannot be combined with --walk\n");
+        return 1;
+    }
+    
     if (wordCount == 0) {
         loadWords("wordList.txt");
     }
@@ -72,55 +163,95 @@ int main() {
     int total_guesses = 0;
     int successful_tests = 0;
     
-    Player player = player_entropy;
+    Player player = use_tree ? player_AI : player_entropy;
+    Strategy strategy = use_tree ? STRATEGY_TREE : STRATEGY_ENTROPY;  // 与 player 对应，--walk 用
+    int mismatches = 0;
+    if (build_book && !use_tree) {
+        printf("Opening book: %d entropy moves\n", book_build(STRATEGY_ENTROPY));
+    }
     printf("\nStarting full test with %d solutions...\n\n", solutionCount);
     
-    clock_t start_time = clock();  // 记录开始时间
+    double start_time = now_seconds();  // 记录开始时间
     
-    // 测试所有solution
-    for (int i = 0; i < solutionCount; i++) {
-        strcpy(results[i].word, solutionList[i]);
-        
-        // 清除上一次的结果
-        found_score = 0;
-        found_guesses = 0;
+    if (parallel || walk || resume) {
+        if (resume) {
+            for (int i = 0; i < solutionCount; i++) {
+                strcpy(results[i].word, solutionList[i]);
+                mismatches += resume_game(strategy, hard, solutionList[i], &results[i]);
+            }
+            printf("Resume check: %d mismatched moves\n\n", mismatches);
+        } else if (walk) {
+            Evaluation eval;
+            if (!evaluate_strategy(strategy, &eval)) {
+                fprintf(stderr, "Evaluation failed\n");
+                free(results);
+                return 1;
+            }
+            printf("Walked %d game states\n\n", eval.states);
+            for (int i = 0; i < solutionCount; i++) {
+                strcpy(results[i].word, solutionList[i]);
+                results[i].guesses = eval.guesses[i] > 0 ? eval.guesses[i] : MAX_ROUNDS;
+                results[i].score = eval.guesses[i] > 0 ? 11 - eval.guesses[i] : 0;
+            }
+            evaluation_free(&eval);
+        } else {
+            feedback_init();  // 先建好共享矩阵，避免各线程同时触发
+            printf("Running in parallel on %d threads\n\n", pool_size());
+            ParallelRun run = { player, results, 0, strategy, hard };
+            pool_run(parallel_worker, &run);
+        }
         
-        // 运行测试
-        test_wordle(solutionList[i], &player);
+        // 按原顺序输出每道题的结果
+        for (int i = 0; i < solutionCount; i++) {
+            if (results[i].score > 0) {
+                total_score += results[i].score;
+                total_guesses += results[i].guesses;
+                successful_tests++;
+                printf("Test %d/%d: %s - Score: %d, Guesses: %d\n", 
+                       i + 1, solutionCount, results[i].word, results[i].score, results[i].guesses);
+            } else {
+                printf("Test %d/%d: %s - Failed\n", i + 1, solutionCount, results[i].word);
+            }
+        }
+    } else {
+        // 测试所有solution
+        SolverContext* state = hard_context(strategy, hard);
+        for (int i = 0; i < solutionCount; i++) {
+            strcpy(results[i].word, solutionList[i]);
         
-        results[i].score = found_score;
-        results[i].guesses = found_guesses;
+            // 运行测试
+            test_wordle(solutionList[i], &player, state, &results[i]);
         
-        if (found_score > 0) {
-            total_score += found_score;
-            total_guesses += found_guesses;
-            successful_tests++;
-            printf("Test %d/%d: %s - Score: %d, Guesses: %d\n", 
-                   i + 1, solutionCount, solutionList[i], found_score, found_guesses);
-        } else {
-            printf("Test %d/%d: %s - Failed\n", i + 1, solutionCount, solutionList[i]);
-        }
+            if (results[i].score > 0) {
+                total_score += results[i].score;
+                total_guesses += results[i].guesses;
+                successful_tests++;
+                printf("Test %d/%d: %s - Score: %d, Guesses: %d\n", 
+                       i + 1, solutionCount, solutionList[i], results[i].score, results[i].guesses);
+            } else {
+                printf("Test %d/%d: %s - Failed\n", i + 1, solutionCount, solutionList[i]);
+            }
         
-        // 每100个测试输出一次统计
-        if ((i + 1) % 100 == 0) {
-            clock_t current_time = clock();
-            double elapsed_time = ((double)(current_time - start_time)) / CLOCKS_PER_SEC;
-            double avg_time_per_word = elapsed_time / (i + 1);
-            double estimated_remaining_time = avg_time_per_word * (solutionCount - (i + 1));
+            // 每100个测试输出一次统计
+            if ((i + 1) % 100 == 0) {
+                double elapsed_time = now_seconds() - start_time;
+                double avg_time_per_word = elapsed_time / (i + 1);
+                double estimated_remaining_time = avg_time_per_word * (solutionCount - (i + 1));
             
-            printf("\nIntermediate results after %d words:\n", i + 1);
-            printf("Time elapsed: %.2f seconds\n", elapsed_time);
-            printf("Average time per word: %.3f seconds\n", avg_time_per_word);
-            printf("Estimated remaining time: %.2f seconds\n", estimated_remaining_time);
-            printf("Successful tests: %d (%.2f%%)\n", 
-                   successful_tests, (float)successful_tests / (i + 1) * 100);
-            printf("Average score: %.2f\n", (float)total_score / successful_tests);
-            printf("Average guesses: %.2f\n\n", (float)total_guesses / successful_tests);
+                printf("\nIntermediate results after %d words:\n", i + 1);
+                printf("Time elapsed: %.2f seconds\n", elapsed_time);
+                printf("Average time per word: %.3f seconds\n", avg_time_per_word);
+                printf("Estimated remaining time: %.2f seconds\n", estimated_remaining_time);
+                printf("Successful tests: %d (%.2f%%)\n", 
+                       successful_tests, (float)successful_tests / (i + 1) * 100);
+                printf("Average score: %.2f\n", (float)total_score / successful_tests);
+                printf("Average guesses: %.2f\n\n", (float)total_guesses / successful_tests);
+            }
         }
+        solver_destroy(state);
     }
     
-    clock_t end_time = clock();
-    double total_time = ((double)(end_time - start_time)) / CLOCKS_PER_SEC;
+    double total_time = now_seconds() - start_time;
     
     printf("\nFinal Test Summary:\n");
     printf("Total time: %.2f seconds\n", total_time);
@@ -147,5 +278,5 @@ int main() {
     }
     
     free(results);
-    return 0;
+    return mismatches > 0;
 }
\ No newline at end of file
@@ -8,6 +8,8 @@
 
 #include "wordle.h"
 #include "player.h"
+#include "feedback.h"
+#include "evaluate.h"
 #include <stdio.h>
 #include <string.h>
 #include <stdbool.h>
@@ -27,7 +29,6 @@ typedef struct {
 } TestResult;
 
 // Global variables to capture test results
-static char last_output[256] = {0};  // Captures wordle output
 static int found_score = 0;          // Score from last test
 static int found_guesses = 0;        // Guesses from last test
 
@@ -50,42 +51,32 @@ void test_wordle(const char solution[WORD_LENGTH + 1], Player *player) {
         return;
     }
     
-    // Initialize feedback for first guess
-    char* lastResult = (char*)malloc(WORD_LENGTH * sizeof(char));
-    for (int i = 0; i < WORD_LENGTH; i++) {
-        lastResult[i] = ' ';
-    }
-    lastResult[WORD_LENGTH] = '\0';
+    // No feedback before the first guess
+    uint8_t lastCode = PATTERN_NONE;
+    char guess[WORD_LENGTH + 1];
     
     // Main game loop
     int i;
     for (i = 0; i < MAX_ROUNDS; i++) {
-        char* guess = (*player)(lastResult);
-        if (not_legal(guess)) {
-            free(guess);
+        if (!(*player)(NULL, lastCode, guess) || not_legal(guess)) {
+            lastCode = PATTERN_INVALID;
             continue;
         }
         
-        char* result = checkWord(solution, guess);
-        if (strcmp(solution, guess) == 0) {
+        uint8_t result = feedback_code(solution, guess);
+        if (result == PATTERN_WIN) {
             // Success - calculate score and guesses
             found_score = 10 - i;
             found_guesses = i + 1;
-            free(guess);
-            free(result);
-            free(lastResult);
             return;
         }
         
-        free(guess);
-        free(lastResult);
-        lastResult = result;
+        lastCode = result;
     }
     
     // Failure case
     found_score = 0;
     found_guesses = MAX_ROUNDS;
-    free(lastResult);
 }
 
 /**
@@ -93,30 +84,36 @@ void test_wordle(const char solution[WORD_LENGTH + 1], Player *player) {
  * 
  * @param used Array tracking used words
  * @param used_count Pointer to count of used words
+ * @param chosen Output solutionList index of the word
  * @return Random unused solution word or NULL if none left
  */
-char* get_solution(bool* used, int* used_count) {
-    if (*used_count >= SOLUTION_LENGTH) {
+char* get_solution(bool* used, int* used_count, int* chosen) {
+    if (*used_count >= solutionCount) {
         return NULL;
     }
     
-    // Find unused random word
+    // Find unused random word among the loaded ones
     int index;
     do {
-        index = rand() % SOLUTION_LENGTH;
+        index = rand() % solutionCount;
     } while (used[index]);
     
     used[index] = true;
     (*used_count)++;
+    *chosen = index;
     
     return solutionList[index];
 }
 
 /**
  * Main program entry point
- * Runs automated tests of player strategy
+ * Runs automated tests of player strategy. With --walk the strategy is
+ * evaluated once over all solutions (evaluate.h) and the sampled tests
+ * read their results from that walk instead of replaying each game.
  */
-int main() {
+int main(int argc, char** argv) {
+    bool walk = argc > 1 && strcmp(argv[1], "--walk") == 0;
+
     srand(time(NULL));  // Initialize random seed
     
     // Load dictionaries if needed
@@ -139,12 +136,22 @@ int main() {
     
     // Select player strategy
     Player player = player_AI;
+    Strategy strategy = STRATEGY_TREE;  // Same strategy, for --walk
+    Evaluation eval = { 0 };
+    if (walk) {
+        if (!evaluate_strategy(strategy, &eval)) {
+            fprintf(stderr, "Evaluation failed\n");
+            return 1;
+        }
+        printf("\nWalked %d game states\n", eval.states);
+    }
     printf("\nStarting %d test cases...\n", TEST_CASES);
     
     // Run test cases
     for (int i = 0; i < TEST_CASES && i < SOLUTION_LENGTH; i++) {
         // Get next test word
-        char* solution = get_solution(used, &used_count);
+        int index;
+        char* solution = get_solution(used, &used_count, &index);
         if (!solution) {
             printf("Run out of solutions after %d tests\n", i);
             break;
@@ -156,7 +163,12 @@ int main() {
         found_guesses = 0;
         
         // Run test and store results
-        test_wordle(solution, &player);
+        if (walk) {
+            found_guesses = eval.guesses[index] > 0 ? eval.guesses[index] : MAX_ROUNDS;
+            found_score = eval.guesses[index] > 0 ? 11 - eval.guesses[index] : 0;
+        } else {
+            test_wordle(solution, &player);
+        }
         results[i].score = found_score;
         results[i].guesses = found_guesses;
         
@@ -200,6 +212,7 @@ int main() {
     // Cleanup
     free(used);
     free(results);
+    evaluation_free(&eval);
     
     return 0;
 }
\ No newline at end of file
@@ -0,0 +1,609 @@
+/**
+ * optimal.c - Exact minimum-guess decision tree search
+ *
+ * The cost of a set S under guess g is |S| (everyone pays for g) plus the
+ * cost of every non-winning bucket g leaves. The lower bound for n answers
+ * fills depths greedily: one answer can be solved in one guess, at most
+ * 242 more in two, 242^2 more in three, and so on. solve() returns the
+ * exact cost of a set when it is below the budget it was given, and
+ * otherwise a lower bound that is at least the budget.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include <math.h>
+#include <inttypes.h>
+#include <pthread.h>
+#include "optimal.h"
+#include "candidates.h"
+#include "feedback.h"
+#include "pool.h"
+
+// ============= Constants =============
+#define OPTIMAL_INFINITY (INT_MAX / 4)   // Cost of a set that cannot be solved in time
+#define MEMO_LOCKS 256                   // Lock stripes over the memo table
+#define CHECKPOINT_LINE_LENGTH 256
+
+// ============= Global Variables =============
+static _Thread_local uint8_t row_scratch[MAX_WORDS];  // Feedback row when there is no matrix
+
+/**
+ * One memoized set
+ */
+typedef struct {
+    uint64_t key1, key2;   // Two hashes of the members, both 0 for an empty slot
+    int32_t value;         // Exact cost, or a lower bound on it
+    int32_t guess;         // Best guess when exact
+    uint8_t depth;         // Guesses left that the value holds for
+    uint8_t exact;         // value is the exact cost
+} MemoEntry;
+
+/**
+ * A guess with the bound of the split it makes
+ */
+typedef struct {
+    int bound;         // Lower bound on the cost with this guess
+    float score;       // Sum of c * log2(c) over the buckets, to break ties
+    int index;         // wordList index
+} BoundedGuess;
+
+/**
+ * State shared by every thread of one search
+ */
+typedef struct {
+    const OptimalOptions* options;
+    MemoEntry* memo;
+    pthread_mutex_t locks[MEMO_LOCKS];
+} Search;
+
+/**
+ * One subtree below the opener
+ */
+typedef struct {
+    uint8_t code;        // Opener feedback leading here
+    const int* set;      // Answers of the subtree
+    int count;
+    DecisionTree tree;   // Optimal subtree, rooted at its own TREE_ROOT
+    bool done;           // Solved in this run or loaded from the checkpoint
+    bool ok;             // A tree within the depth limit exists
+} OptimalJob;
+
+/**
+ * Shared state of the subtree jobs
+ */
+typedef struct {
+    Search* search;
+    OptimalJob* jobs;
+    int* order;                  // Job indices, largest subtree first
+    int job_count;
+    int next;                    // Next position in order to claim
+    int finished;                // Jobs done so far
+    const char* opener;
+    bool opener_solves;          // The opener is itself an answer
+    uint64_t answers_hash;
+    pthread_mutex_t lock;        // Guards finished, done flags and the checkpoint
+} OptimalRun;
+
+// ============= Bounds and Hashing =============
+
+/**
+ * Fewest total guesses any tree could need for n answers within depth
+ * @return The bound, or OPTIMAL_INFINITY if n answers cannot fit
+ */
+static int lower_bound(int n, int depth) {
+    int total = 0;
+    long width = 1;   // Answers that can be solved at this level
+    for (int level = 1; n > 0; level++) {
+        if (level > depth) return OPTIMAL_INFINITY;
+        int here = n < width ? n : (int)width;
+        total += here * level;
+        n -= here;
+        width *= PATTERN_COUNT - 1;
+    }
+    return total;
+}
+
+/**
+ * Hashes a sorted set two independent ways
+ */
+static void hash_set(const int* set, int n, uint64_t* key1, uint64_t* key2) {
+    uint64_t h1 = 14695981039346656037ULL;
+    uint64_t h2 = (uint64_t)n * 0x9E3779B97F4A7C15ULL;
+    for (int i = 0; i < n; i++) {
+        h1 = (h1 ^ (uint64_t)set[i]) * 1099511628211ULL;
+        uint64_t z = h2 + (uint64_t)set[i] + 0x9E3779B97F4A7C15ULL;
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+        h2 = z ^ (z >> 31);
+    }
+    *key1 = h1;
+    *key2 = h2;
+}
+
+// ============= Memo Table =============
+
+static bool memo_find(Search* s, uint64_t key1, uint64_t key2, int depth, MemoEntry* out) {
+    size_t slot = key1 & ((1u << OPTIMAL_MEMO_BITS) - 1);
+    pthread_mutex_t* lock = &s->locks[slot % MEMO_LOCKS];
+    pthread_mutex_lock(lock);
+    *out = s->memo[slot];
+    pthread_mutex_unlock(lock);
+    return out->key1 == key1 && out->key2 == key2 && out->depth == depth;
+}
+
+/**
+ * Stores a result, never replacing an exact cost of the same set by a bound
+ */
+static void memo_store(Search* s, uint64_t key1, uint64_t key2, int depth, int value,
+                       int guess, bool exact) {
+    size_t slot = key1 & ((1u << OPTIMAL_MEMO_BITS) - 1);
+    pthread_mutex_t* lock = &s->locks[slot % MEMO_LOCKS];
+    pthread_mutex_lock(lock);
+    MemoEntry* entry = &s->memo[slot];
+    bool same = entry->key1 == key1 && entry->key2 == key2 && entry->depth == depth;
+    if (!(same && entry->exact && !exact)) {
+        entry->key1 = key1;
+        entry->key2 = key2;
+        entry->value = value;
+        entry->guess = guess;
+        entry->depth = (uint8_t)depth;
+        entry->exact = exact;
+    }
+    pthread_mutex_unlock(lock);
+}
+
+// ============= Search =============
+
+/**
+ * Sorts a set into buckets by the guess's feedback (stable)
+ * @param offsets Output, bucket c is buckets[offsets[c] .. offsets[c + 1])
+ */
+static void partition(int guess, const int* set, int count, int* buckets,
+                      int offsets[PATTERN_COUNT + 1]) {
+    const uint8_t* row = feedback_scan(guess, row_scratch);
+    int fill[PATTERN_COUNT] = {0};
+    for (int i = 0; i < count; i++) {
+        fill[row[set[i]]]++;
+    }
+    offsets[0] = 0;
+    for (int c = 0; c < PATTERN_COUNT; c++) {
+        offsets[c + 1] = offsets[c] + fill[c];
+        fill[c] = offsets[c];
+    }
+    for (int i = 0; i < count; i++) {
+        buckets[fill[row[set[i]]]++] = set[i];
+    }
+}
+
+static int compare_indices(const void* a, const void* b) {
+    return *(const int*)a - *(const int*)b;
+}
+
+static int compare_guesses(const void* a, const void* b) {
+    const BoundedGuess* x = (const BoundedGuess*)a;
+    const BoundedGuess* y = (const BoundedGuess*)b;
+    if (x->bound != y->bound) return x->bound < y->bound ? -1 : 1;
+    if (x->score != y->score) return x->score < y->score ? -1 : 1;
+    return x->index - y->index;
+}
+
+/**
+ * Bounds every useful guess for a set, most promising first
+ * @return Number of guesses stored in out
+ */
+static int bound_guesses(const int* set, int n, int depth, BoundedGuess* out) {
+    int kept = 0;
+    int counts[PATTERN_COUNT];
+    for (int g = 0; g < wordCount; g++) {
+        const uint8_t* row = feedback_scan(g, row_scratch);
+        memset(counts, 0, sizeof(counts));
+        for (int i = 0; i < n; i++) {
+            counts[row[set[i]]]++;
+        }
+
+        BoundedGuess guess = { n, 0.0f, g };
+        bool useful = counts[PATTERN_WIN] > 0;
+        for (int c = 0; c < PATTERN_COUNT && guess.bound < OPTIMAL_INFINITY; c++) {
+            if (!counts[c]) continue;
+            if (counts[c] < n) useful = true;
+            guess.score += counts[c] * log2f((float)counts[c]);
+            if (c != PATTERN_WIN) {
+                guess.bound += lower_bound(counts[c], depth - 1);
+            }
+        }
+        if (useful && guess.bound < OPTIMAL_INFINITY) {
+            out[kept++] = guess;
+        }
+    }
+    qsort(out, kept, sizeof(BoundedGuess), compare_guesses);
+    return kept;
+}
+
+/**
+ * Finds the cheapest tree for a sorted set
+ * @param depth Guesses left
+ * @param budget Costs at or above this are not interesting
+ * @param best_guess Output, the first guess of the cheapest tree when exact
+ * @return Exact cost if below budget, otherwise a lower bound >= budget
+ */
+static int solve(Search* s, const int* set, int n, int depth, int budget, int* best_guess) {
+    int bound = lower_bound(n, depth);
+    if (n <= 2 || bound >= OPTIMAL_INFINITY) {
+        // One answer: guess it. Two: guess either, then the other.
+        *best_guess = set[0];
+        return bound;
+    }
+    if (bound >= budget) return bound;
+
+    uint64_t key1, key2;
+    hash_set(set, n, &key1, &key2);
+    MemoEntry entry;
+    if (memo_find(s, key1, key2, depth, &entry)) {
+        if (entry.exact) {
+            *best_guess = entry.guess;
+            return entry.value;
+        }
+        if (entry.value > bound) bound = entry.value;
+        if (bound >= budget) return bound;
+    }
+
+    // An answer that tells all the others apart meets the bound exactly
+    if (bound == 2 * n - 1) {
+        for (int i = 0; i < n; i++) {
+            const uint8_t* row = feedback_scan(set[i], row_scratch);
+            bool seen[PATTERN_COUNT] = {false};
+            bool distinct = true;
+            for (int j = 0; j < n && distinct; j++) {
+                distinct = !seen[row[set[j]]];
+                seen[row[set[j]]] = true;
+            }
+            if (distinct) {
+                *best_guess = set[i];
+                return bound;
+            }
+        }
+    }
+
+    BoundedGuess* guesses = (BoundedGuess*)malloc(wordCount * sizeof(BoundedGuess));
+    int* buckets = (int*)malloc(n * sizeof(int));
+    if (!guesses || !buckets) {
+        free(guesses);
+        free(buckets);
+        return OPTIMAL_INFINITY;
+    }
+    int kept = bound_guesses(set, n, depth, guesses);
+    if (s->options->guess_limit > 0 && kept > s->options->guess_limit) {
+        kept = s->options->guess_limit;
+    }
+
+    int best = budget;
+    int best_index = -1;
+    for (int i = 0; i < kept && guesses[i].bound < best; i++) {
+        int offsets[PATTERN_COUNT + 1];
+        partition(guesses[i].index, set, n, buckets, offsets);
+
+        // Replace each bucket's bound by its cost until the guess is beaten
+        int total = guesses[i].bound;
+        for (int code = 0; code < PATTERN_COUNT && total < best; code++) {
+            int size = offsets[code + 1] - offsets[code];
+            if (code == PATTERN_WIN || size == 0) continue;
+            int child_bound = lower_bound(size, depth - 1);
+            int child_guess;
+            int cost = solve(s, buckets + offsets[code], size, depth - 1,
+                             best - (total - child_bound), &child_guess);
+            total += cost - child_bound;
+        }
+        if (total < best) {
+            best = total;
+            best_index = guesses[i].index;
+        }
+    }
+    free(guesses);
+    free(buckets);
+
+    if (best_index >= 0) {
+        memo_store(s, key1, key2, depth, best, best_index, true);
+        *best_guess = best_index;
+        return best;
+    }
+    memo_store(s, key1, key2, depth, budget, -1, false);
+    return budget;
+}
+
+/**
+ * Builds the cheapest tree for a set, re-solving where the memo forgot
+ * @return Node of the set's first guess, TREE_NONE on failure
+ */
+static int construct(Search* s, DecisionTree* tree, const int* set, int n, int depth) {
+    int guess;
+    if (solve(s, set, n, depth, OPTIMAL_INFINITY, &guess) >= OPTIMAL_INFINITY) return TREE_NONE;
+
+    int* buckets = (int*)malloc(n * sizeof(int));
+    if (!buckets) return TREE_NONE;
+    int offsets[PATTERN_COUNT + 1];
+    partition(guess, set, n, buckets, offsets);
+
+    bool solves = offsets[PATTERN_WIN + 1] > offsets[PATTERN_WIN];
+    int node = tree_add_node(tree, wordPacked[guess] | (solves ? TREE_SOLVES : 0));
+    for (int code = 0; code < PATTERN_COUNT && node != TREE_NONE; code++) {
+        int size = offsets[code + 1] - offsets[code];
+        if (code == PATTERN_WIN || size == 0) continue;
+        int child = construct(s, tree, buckets + offsets[code], size, depth - 1);
+        if (child == TREE_NONE || !tree_set_child(tree, node, (uint8_t)code, child)) {
+            node = TREE_NONE;
+        }
+    }
+    free(buckets);
+    return node;
+}
+
+// ============= Checkpoints =============
+
+/**
+ * Writes the header identifying a search
+ */
+static void write_header(FILE* file, const OptimalRun* run) {
+    fprintf(file, "# optimal opener=%s words=%016" PRIx64 " answers=%016" PRIx64
+            " depth=%d guesses=%d\n", run->opener, hashWords(wordList, wordCount),
+            run->answers_hash, run->search->options->max_depth,
+            run->search->options->guess_limit);
+}
+
+/**
+ * Rewrites the checkpoint with every finished subtree
+ * Called with run->lock held.
+ */
+static void save_checkpoint(const OptimalRun* run) {
+    const char* path = run->search->options->checkpoint;
+    if (!path) return;
+
+    DecisionTree partial;
+    memset(&partial, 0, sizeof(partial));
+    bool ok = tree_add_node(&partial, packWord(run->opener) |
+                            (run->opener_solves ? TREE_SOLVES : 0)) == TREE_ROOT;
+    for (int j = 0; ok && j < run->job_count; j++) {
+        const OptimalJob* job = &run->jobs[j];
+        if (!job->done || !job->ok) continue;
+        int root = tree_copy_subtree(&partial, &job->tree, TREE_ROOT);
+        ok = root != TREE_NONE && tree_set_child(&partial, TREE_ROOT, job->code, root);
+    }
+
+    char temp_name[256];
+    snprintf(temp_name, sizeof(temp_name), "%s.tmp", path);
+    FILE* file = ok ? fopen(temp_name, "w") : NULL;
+    if (file) {
+        write_header(file, run);
+        for (int j = 0; j < run->job_count; j++) {
+            if (!run->jobs[j].done || !run->jobs[j].ok) continue;
+            char pattern[WORD_LENGTH + 1];
+            decodeFeedback(run->jobs[j].code, pattern);
+            fprintf(file, "# done %s\n", pattern);
+        }
+        if (partial.table_count > 0) {
+            tree_write_text(&partial, file);
+        }
+        ok = !ferror(file);
+        ok = (fclose(file) == 0) && ok;
+        if (!ok || rename(temp_name, path) != 0) {
+            remove(temp_name);
+        }
+    }
+    tree_free(&partial);
+}
+
+/**
+ * Reuses the subtrees of a checkpoint written for the same search
+ * @return Number of subtrees restored
+ */
+static int load_checkpoint(OptimalRun* run) {
+    const char* path = run->search->options->checkpoint;
+    FILE* file = path ? fopen(path, "r") : NULL;
+    if (!file) return 0;
+
+    // The header must match this search exactly
+    char expected[CHECKPOINT_LINE_LENGTH], line[CHECKPOINT_LINE_LENGTH];
+    FILE* header = fmemopen(expected, sizeof(expected), "w");
+    if (!header) {
+        fclose(file);
+        return 0;
+    }
+    write_header(header, run);
+    fclose(header);
+    if (!fgets(line, sizeof(line), file) || strcmp(line, expected) != 0) {
+        fclose(file);
+        return 0;
+    }
+
+    bool done_codes[PATTERN_COUNT] = {false};
+    while (fgets(line, sizeof(line), file) && strncmp(line, "# done ", 7) == 0) {
+        char pattern[WORD_LENGTH + 1];
+        if (sscanf(line + 7, "%5s", pattern) == 1) {
+            uint8_t code = encodeFeedback(pattern);
+            if (code != PATTERN_INVALID) done_codes[code] = true;
+        }
+    }
+    fclose(file);
+
+    DecisionTree saved;
+    if (!tree_load(&saved, path)) return 0;
+    int restored = 0;
+    if ((saved.nodes[TREE_ROOT].word & TREE_WORD_MASK) == packWord(run->opener)) {
+        for (int j = 0; j < run->job_count; j++) {
+            OptimalJob* job = &run->jobs[j];
+            int child = tree_child(&saved, TREE_ROOT, job->code);
+            if (!done_codes[job->code] || child == TREE_NONE) continue;
+            if (tree_copy_subtree(&job->tree, &saved, child) == TREE_ROOT) {
+                job->done = job->ok = true;
+                restored++;
+            } else {
+                tree_free(&job->tree);
+            }
+        }
+    }
+    tree_free(&saved);
+    return restored;
+}
+
+// ============= Parallel Search =============
+
+/**
+ * Pool job: solves whole subtrees below the opener, largest first
+ */
+static void optimal_worker(void* arg, int worker, int workers) {
+    OptimalRun* run = (OptimalRun*)arg;
+    (void)worker;
+    (void)workers;
+    int depth = run->search->options->max_depth - 1;
+
+    int i;
+    while ((i = __atomic_fetch_add(&run->next, 1, __ATOMIC_RELAXED)) < run->job_count) {
+        OptimalJob* job = &run->jobs[run->order[i]];
+        if (job->done) continue;
+
+        DecisionTree tree;
+        memset(&tree, 0, sizeof(tree));
+        bool ok = construct(run->search, &tree, job->set, job->count, depth) == TREE_ROOT;
+
+        TreeStats stats;
+        tree_measure(&tree, depth, &stats);
+        char pattern[WORD_LENGTH + 1];
+        decodeFeedback(job->code, pattern);
+
+        pthread_mutex_lock(&run->lock);
+        job->tree = tree;
+        job->ok = ok;
+        job->done = true;
+        run->finished++;
+        if (ok) {
+            printf("Solved %s %s: %d answers, %ld guesses (%d/%d)\n", run->opener, pattern,
+                   job->count, stats.total_guesses + job->count, run->finished, run->job_count);
+        } else {
+            printf("No tree for %s %s within the depth limit (%d/%d)\n", run->opener, pattern,
+                   run->finished, run->job_count);
+        }
+        fflush(stdout);
+        save_checkpoint(run);
+        pthread_mutex_unlock(&run->lock);
+    }
+}
+
+// ============= Search Functions =============
+
+void optimal_default_options(OptimalOptions* options) {
+    options->max_depth = MAX_ROUNDS;
+    options->guess_limit = 0;
+    options->checkpoint = NULL;
+}
+
+bool optimal_build(DecisionTree* tree, const char* opener, const int* answers, int count,
+                   const OptimalOptions* options, TreeStats* stats) {
+    memset(tree, 0, sizeof(*tree));
+    int opener_index = word_index(opener);
+    if (opener_index < 0 || count <= 0 || options->max_depth < 1 ||
+        options->max_depth > UINT8_MAX || options->guess_limit < 0) {
+        return false;
+    }
+    feedback_init();
+
+    Search search;
+    search.options = options;
+    search.memo = (MemoEntry*)calloc((size_t)1 << OPTIMAL_MEMO_BITS, sizeof(MemoEntry));
+    int* buckets = (int*)malloc(count * sizeof(int));
+    OptimalJob* jobs = (OptimalJob*)calloc(PATTERN_COUNT, sizeof(OptimalJob));
+    int* order = (int*)malloc(PATTERN_COUNT * sizeof(int));
+    if (!search.memo || !buckets || !jobs || !order) {
+        free(search.memo);
+        free(buckets);
+        free(jobs);
+        free(order);
+        return false;
+    }
+    for (int i = 0; i < MEMO_LOCKS; i++) {
+        pthread_mutex_init(&search.locks[i], NULL);
+    }
+
+    // Sorting makes the member order of every set canonical for hashing
+    int* sorted = (int*)malloc(count * sizeof(int));
+    if (!sorted) {
+        free(search.memo);
+        free(buckets);
+        free(jobs);
+        free(order);
+        return false;
+    }
+    memcpy(sorted, answers, count * sizeof(int));
+    qsort(sorted, count, sizeof(int), compare_indices);
+
+    // One job per non-empty bucket of the opener, claimed largest first
+    int offsets[PATTERN_COUNT + 1];
+    partition(opener_index, sorted, count, buckets, offsets);
+    int job_count = 0;
+    for (int code = 0; code < PATTERN_COUNT; code++) {
+        int size = offsets[code + 1] - offsets[code];
+        if (code == PATTERN_WIN || size == 0) continue;
+        OptimalJob* job = &jobs[job_count];
+        job->code = (uint8_t)code;
+        job->set = buckets + offsets[code];
+        job->count = size;
+
+        int i = job_count++;
+        while (i > 0 && jobs[order[i - 1]].count < size) {
+            order[i] = order[i - 1];
+            i--;
+        }
+        order[i] = job_count - 1;
+    }
+
+    OptimalRun run;
+    run.search = &search;
+    run.jobs = jobs;
+    run.order = order;
+    run.job_count = job_count;
+    run.next = 0;
+    run.opener = wordList[opener_index];
+    run.opener_solves = offsets[PATTERN_WIN + 1] > offsets[PATTERN_WIN];
+    run.answers_hash = 0;
+    uint64_t unused;
+    hash_set(sorted, count, &run.answers_hash, &unused);
+    free(sorted);
+    pthread_mutex_init(&run.lock, NULL);
+
+    run.finished = load_checkpoint(&run);
+    if (run.finished > 0) {
+        printf("Resumed %d of %d subtrees from %s\n", run.finished, job_count, options->checkpoint);
+    }
+    bool ok = options->max_depth > 1 || job_count == 0;
+    if (ok) {
+        pool_run(optimal_worker, &run);
+    }
+
+    // Attach the subtrees in code order
+    ok = ok && tree_add_node(tree, packWord(run.opener) |
+                             (run.opener_solves ? TREE_SOLVES : 0)) == TREE_ROOT;
+    for (int j = 0; j < job_count; j++) {
+        ok = ok && jobs[j].ok;
+        int root = ok ? tree_copy_subtree(tree, &jobs[j].tree, TREE_ROOT) : TREE_NONE;
+        ok = root != TREE_NONE && tree_set_child(tree, TREE_ROOT, jobs[j].code, root);
+        tree_free(&jobs[j].tree);
+    }
+
+    pthread_mutex_destroy(&run.lock);
+    for (int i = 0; i < MEMO_LOCKS; i++) {
+        pthread_mutex_destroy(&search.locks[i]);
+    }
+    free(search.memo);
+    free(buckets);
+    free(jobs);
+    free(order);
+
+    if (!ok) {
+        tree_free(tree);
+        return false;
+    }
+    if (stats) {
+        tree_measure(tree, options->max_depth, stats);
+    }
+    return true;
+}
@@ -0,0 +1,57 @@
+/**
+ * optimal.h - Exact minimum-guess decision tree search
+ *
+ * Finds, for a fixed opener, the decision tree that minimizes the total
+ * (hence expected) number of guesses over a set of answers, optionally
+ * with a worst-case depth limit. The search is a depth-first branch and
+ * bound: each guess is first bounded by the sizes of the sets it leaves,
+ * subtrees are solved against the remaining budget, and solved or pruned
+ * sets are memoized by a hash of their members. Subtrees below the opener
+ * are solved on the worker pool, and each finished one is checkpointed so
+ * an interrupted run resumes where it stopped.
+ */
+
+#ifndef OPTIMAL_H
+#define OPTIMAL_H
+
+#include <stdbool.h>
+#include "wordle.h"
+#include "tree.h"
+
+// ============= Constants =============
+#define OPTIMAL_MEMO_BITS 21      // Memo table holds 2^21 sets
+
+/**
+ * Search settings
+ */
+typedef struct {
+    int max_depth;            // Guesses allowed per game (hard limit)
+    int guess_limit;          // Guesses tried per set, best splits first; 0 = all (exact)
+    const char* checkpoint;   // Progress file, NULL for none
+} OptimalOptions;
+
+// ============= Search Functions =============
+
+/**
+ * Fills options for an exact search within MAX_ROUNDS and no checkpoint
+ * @param options Options to initialize
+ */
+void optimal_default_options(OptimalOptions* options);
+
+/**
+ * Searches the minimum-guess tree
+ * If options->checkpoint names a file written by an interrupted search
+ * with the same opener, lists and settings, its finished subtrees are
+ * reused.
+ * @param tree Output tree (overwritten; free with tree_free)
+ * @param opener First guess, must be in wordList
+ * @param answers wordList indices of the possible answers, without repeats
+ * @param count Number of answers
+ * @param options Search settings
+ * @param stats Output quality of the tree, may be NULL
+ * @return true if a tree within the depth limit was found
+ */
+bool optimal_build(DecisionTree* tree, const char* opener, const int* answers, int count,
+                   const OptimalOptions* options, TreeStats* stats);
+
+#endif
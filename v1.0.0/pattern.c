@@ -0,0 +1,143 @@
+/**
+ * pattern.c - Letter-position index and pattern queries
+ *
+ * A query gathers the bitsets it needs first, then walks the list once,
+ * block by block, so each result block is finished while its inputs are
+ * in cache. Only the blocks covering the list are touched.
+ */
+
+#include "pattern.h"
+#include <ctype.h>
+#include <string.h>
+
+// ============= Global Variables =============
+static LetterIndex word_letters;
+static LetterIndex solution_letters;
+
+// ============= Index Functions =============
+
+/**
+ * Fills an index from packed words; PACKED_INVALID words match nothing
+ */
+static void build_index(LetterIndex* index, const uint32_t* packed, int count) {
+    memset(index, 0, sizeof(*index));
+    for (int w = 0; w < count; w++) {
+        if (packed[w] == PACKED_INVALID) continue;
+        uint32_t letters = packed[w];
+        for (int i = WORD_LENGTH - 1; i >= 0; i--) {
+            int l = letters & 31;
+            letters >>= 5;
+            candidates_add(&index->at[i][l], w);
+            candidates_add(&index->has[l], w);
+        }
+        candidates_add(&index->all, w);
+    }
+    index->size = count;
+}
+
+void pattern_index_words(void) {
+    build_index(&word_letters, wordPacked, wordCount);
+}
+
+void pattern_index_solutions(void) {
+    build_index(&solution_letters, solutionPacked, solutionCount);
+}
+
+const LetterIndex* pattern_words(void) {
+    return &word_letters;
+}
+
+const LetterIndex* pattern_solutions(void) {
+    return &solution_letters;
+}
+
+// ============= Query Functions =============
+
+void pattern_clear(PatternQuery* query) {
+    memset(query, 0, sizeof(*query));
+}
+
+/**
+ * Adds the letters of a "+R" or "-T" term to a letter mask
+ */
+static bool parse_letters(const char* term, size_t length, uint32_t* mask) {
+    if (length == 0) return false;
+    for (size_t k = 0; k < length; k++) {
+        if (!isalpha((unsigned char)term[k])) return false;
+        *mask |= LETTER_BIT(toupper((unsigned char)term[k]));
+    }
+    return true;
+}
+
+bool pattern_parse(const char* text, PatternQuery* query) {
+    pattern_clear(query);
+    while (*text) {
+        if (isspace((unsigned char)*text)) {
+            text++;
+            continue;
+        }
+        size_t length = 0;
+        while (text[length] && !isspace((unsigned char)text[length])) length++;
+
+        if (*text == '+') {
+            if (!parse_letters(text + 1, length - 1, &query->present)) return false;
+        } else if (*text == '-') {
+            if (!parse_letters(text + 1, length - 1, &query->absent)) return false;
+        } else {
+            if (length != WORD_LENGTH) return false;
+            for (int i = 0; i < WORD_LENGTH; i++) {
+                char c = text[i];
+                if (c == '?' || c == '.' || c == '_') {
+                    query->fixed[i] = 0;
+                } else if (isalpha((unsigned char)c)) {
+                    query->fixed[i] = (char)toupper((unsigned char)c);
+                } else {
+                    return false;
+                }
+            }
+        }
+        text += length;
+    }
+    return true;
+}
+
+bool pattern_add_hints(PatternQuery* query, const char guess[WORD_LENGTH + 1], uint8_t code) {
+    if (code >= PATTERN_COUNT || packCanonical(guess) == PACKED_INVALID) return false;
+    for (int i = WORD_LENGTH - 1; i >= 0; i--) {
+        if (code % 3 == 2) {
+            query->fixed[i] = guess[i];
+        } else if (code % 3 == 1) {
+            query->present |= LETTER_BIT(guess[i]);
+        }
+        code /= 3;
+    }
+    return true;
+}
+
+int pattern_match(const LetterIndex* index, const PatternQuery* query, CandidateSet* result) {
+    const uint64_t* with[WORD_LENGTH + ALPHABET_SIZE];
+    const uint64_t* without[ALPHABET_SIZE];
+    int n_with = 0, n_without = 0;
+    for (int i = 0; i < WORD_LENGTH; i++) {
+        if (query->fixed[i]) {
+            with[n_with++] = index->at[i][query->fixed[i] - 'A'].bits;
+        }
+    }
+    for (int l = 0; l < ALPHABET_SIZE; l++) {
+        if (query->present & (1u << l)) with[n_with++] = index->has[l].bits;
+        if (query->absent & (1u << l)) without[n_without++] = index->has[l].bits;
+    }
+
+    int blocks = (index->size + 63) / 64;
+    memset(result->bits, 0, sizeof(result->bits));
+    int count = 0;
+    for (int b = 0; b < blocks; b++) {
+        uint64_t bits = index->all.bits[b];
+        for (int k = 0; k < n_with && bits; k++) bits &= with[k][b];
+        for (int k = 0; k < n_without && bits; k++) bits &= ~without[k][b];
+        result->bits[b] = bits;
+        count += __builtin_popcountll(bits);
+    }
+    result->count = count;
+    return count;
+}
@@ -0,0 +1,110 @@
+/**
+ * pattern.h - Letter-position index and pattern queries over the word lists
+ *
+ * For each of wordList and solutionList the index keeps one bitset per
+ * (position, letter) pair and one per letter anywhere in the word, with
+ * bit i standing for list index i. A query such as "S?A?E, contains R,
+ * no T" is then the intersection of a few bitsets (the absent letters
+ * subtracted), one 64-bit block at a time, instead of a scan of every word.
+ * The indexes are rebuilt by loadWords() and loadSolution().
+ *
+ * The same queries describe hard mode: every green must be played in place
+ * and every yellow somewhere in the next guess.
+ */
+
+#ifndef PATTERN_H
+#define PATTERN_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "wordle.h"
+#include "columns.h"
+#include "candidates.h"
+
+/**
+ * Bitsets of one word list
+ */
+typedef struct {
+    CandidateSet at[WORD_LENGTH][ALPHABET_SIZE];   // Words with letter 'A' + l at position i
+    CandidateSet has[ALPHABET_SIZE];               // Words containing letter 'A' + l
+    CandidateSet all;                              // Every word of the list
+    int size;                                      // Words indexed
+} LetterIndex;
+
+/**
+ * Pattern of known letters with letters required and excluded anywhere
+ */
+typedef struct {
+    char fixed[WORD_LENGTH];   // Upper case letter required at each position, 0 for any
+    uint32_t present;          // LETTER_BIT of each letter that must occur
+    uint32_t absent;           // LETTER_BIT of each letter that must not occur
+} PatternQuery;
+
+// ============= Index Functions =============
+
+/**
+ * Rebuilds the index of wordList from wordPacked
+ * Called by loadWords(); not safe while other threads query.
+ */
+void pattern_index_words(void);
+
+/**
+ * Rebuilds the index of solutionList from solutionPacked
+ * Called by loadSolution(); not safe while other threads query.
+ */
+void pattern_index_solutions(void);
+
+/**
+ * The index of wordList (bits are wordList indices)
+ * @return Index, empty until loadWords()
+ */
+const LetterIndex* pattern_words(void);
+
+/**
+ * The index of solutionList (bits are solutionList indices)
+ * @return Index, empty until loadSolution()
+ */
+const LetterIndex* pattern_solutions(void);
+
+// ============= Query Functions =============
+
+/**
+ * Starts a query that every word matches
+ * @param query Query to reset
+ */
+void pattern_clear(PatternQuery* query);
+
+/**
+ * Parses a query from text
+ * Whitespace separated terms, letters in either case:
+ *   S?A?E   letters by position, '?', '.' or '_' for any letter
+ *   +R      letters that must occur
+ *   -T      letters that must not occur
+ * e.g. "S?A?E +R -T"
+ * @param text Query text
+ * @param query Output query (reset first)
+ * @return false if a term is malformed
+ */
+bool pattern_parse(const char* text, PatternQuery* query);
+
+/**
+ * Adds the hard mode hints of one round: greens fix their position,
+ * yellows must occur. Black letters are not excluded, as in hard mode.
+ * @param query Query to extend
+ * @param guess Word played, WORD_LENGTH upper case letters
+ * @param code Feedback code received for it
+ * @return false (leaving the query unchanged) if the guess is not a word
+ *         of letters or the code is not a feedback code
+ */
+bool pattern_add_hints(PatternQuery* query, const char guess[WORD_LENGTH + 1], uint8_t code);
+
+/**
+ * Finds every word of a list matching a query
+ * @param index Index of the list to search
+ * @param query Query
+ * @param result Output set of list indices (overwritten)
+ * @return Number of matching words
+ */
+int pattern_match(const LetterIndex* index, const PatternQuery* query, CandidateSet* result);
+
+#endif
@@ -4,47 +4,64 @@
 #include "wordle.h"
 
 // ============= Player Strategy Functions =============
+// Every player writes its guess to the caller's buffer. The strategy
+// players (frequency, minimax, entropy, AI) take a SolverContext as their
+// state, initialized with solver_init() for the strategy, one per game in
+// flight; with a NULL state they use a context of the calling thread.
+// The input and random players keep no state.
 
 /**
  * Human player interface
- * @param lastResult Previous guess feedback
- * @return Player's input word
+ * @param state Unused
+ * @param lastCode Previous guess feedback code
+ * @param guess Output, player's input word
+ * @return false if the input ended
  */
-char* player_input(const char lastResult[WORD_LENGTH + 1]);
+bool player_input(void* state, uint8_t lastCode, char guess[WORD_LENGTH + 1]);
 
 /**
  * Random guessing strategy
- * @param lastResult Previous guess feedback
- * @return Randomly selected word
+ * @param state Unused
+ * @param lastCode Previous guess feedback code
+ * @param guess Output, randomly selected word
+ * @return false if no words are loaded
  */
-char* player_random(const char lastResult[WORD_LENGTH + 1]);
+bool player_random(void* state, uint8_t lastCode, char guess[WORD_LENGTH + 1]);
 
 /**
  * Information entropy based strategy
- * @param lastResult Previous guess feedback
- * @return Word with maximum information gain
+ * @param state SolverContext of the game, or NULL
+ * @param lastCode Previous guess feedback code
+ * @param guess Output, word with maximum information gain
+ * @return false if there is no move
  */
-char* player_entropy(const char lastResult[WORD_LENGTH + 1]);
+bool player_entropy(void* state, uint8_t lastCode, char guess[WORD_LENGTH + 1]);
 
 /**
  * Minimax strategy implementation
- * @param lastResult Previous guess feedback
- * @return Word that minimizes maximum possible solutions
+ * @param state SolverContext of the game, or NULL
+ * @param lastCode Previous guess feedback code
+ * @param guess Output, word that minimizes maximum possible solutions
+ * @return false if there is no move
  */
-char* player_minimax(const char lastResult[WORD_LENGTH + 1]);
+bool player_minimax(void* state, uint8_t lastCode, char guess[WORD_LENGTH + 1]);
 
 /**
  * Letter frequency based strategy
- * @param lastResult Previous guess feedback
- * @return Word based on letter frequency analysis
+ * @param state SolverContext of the game, or NULL
+ * @param lastCode Previous guess feedback code
+ * @param guess Output, word based on letter frequency analysis
+ * @return false if there is no move
  */
-char* player_frequency(const char lastResult[WORD_LENGTH + 1]);
+bool player_frequency(void* state, uint8_t lastCode, char guess[WORD_LENGTH + 1]);
 
 /**
  * Decision tree based AI strategy
- * @param lastResult Previous guess feedback
- * @return Word chosen from decision tree
+ * @param state SolverContext of the game, or NULL
+ * @param lastCode Previous guess feedback code
+ * @param guess Output, word chosen from decision tree
+ * @return false if there is no move
  */
-char* player_AI(const char lastResult[WORD_LENGTH + 1]);
+bool player_AI(void* state, uint8_t lastCode, char guess[WORD_LENGTH + 1]);
 
-#endif
\ No newline at end of file
+#endif
@@ -0,0 +1,150 @@
+/**
+ * pool.c - Persistent worker pool implementation
+ *
+ * Workers wait on a condition variable for the job generation to change,
+ * run their share, and report back through a countdown. Only one job is
+ * in flight at a time; busy or nested submissions run inline.
+ */
+
+#include "pool.h"
+#include <stdbool.h>
+#include <stdlib.h>
+#include <pthread.h>
+#include <unistd.h>
+
+// ============= Global Variables =============
+static pthread_mutex_t submit_lock = PTHREAD_MUTEX_INITIALIZER;  // Held while a job runs
+static pthread_mutex_t state_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t job_ready = PTHREAD_COND_INITIALIZER;
+static pthread_cond_t job_done = PTHREAD_COND_INITIALIZER;
+
+static pthread_t threads[POOL_MAX_THREADS];
+static int thread_count = 0;      // Workers including the submitting thread
+static bool started = false;
+static bool stopping = false;
+
+static PoolTask current_task = NULL;
+static void* current_arg = NULL;
+static unsigned long generation = 0;   // Bumped for every job
+static unsigned long spawn_generation = 0;  // Generation when the workers started
+static int pending = 0;                // Helper workers still running the job
+
+static _Thread_local bool in_worker = false;  // Set on pool threads and during jobs
+
+// ============= Worker Threads =============
+
+/**
+ * Main loop of helper worker `worker` (1..thread_count-1)
+ */
+static void* worker_main(void* arg) {
+    int worker = (int)(long)arg;
+    in_worker = true;
+
+    pthread_mutex_lock(&state_lock);
+    unsigned long seen = spawn_generation;
+    while (true) {
+        while (!stopping && generation == seen) {
+            pthread_cond_wait(&job_ready, &state_lock);
+        }
+        if (stopping) break;
+        seen = generation;
+        PoolTask task = current_task;
+        void* task_arg = current_arg;
+        int workers = thread_count;
+        pthread_mutex_unlock(&state_lock);
+
+        task(task_arg, worker, workers);
+
+        pthread_mutex_lock(&state_lock);
+        if (--pending == 0) {
+            pthread_cond_signal(&job_done);
+        }
+    }
+    pthread_mutex_unlock(&state_lock);
+    return NULL;
+}
+
+/**
+ * Picks the pool size and starts the helper threads
+ */
+static void start_pool(void) {
+    long wanted = sysconf(_SC_NPROCESSORS_ONLN);
+    const char* env = getenv(POOL_THREADS_ENV);
+    if (env && atoi(env) > 0) {
+        wanted = atoi(env);
+    }
+    if (wanted < 1) wanted = 1;
+    if (wanted > POOL_MAX_THREADS) wanted = POOL_MAX_THREADS;
+
+    spawn_generation = generation;
+    thread_count = 1;
+    for (int t = 1; t < wanted; t++) {
+        if (pthread_create(&threads[t], NULL, worker_main, (void*)(long)t) != 0) break;
+        thread_count++;
+    }
+    started = true;
+}
+
+// ============= Pool Functions =============
+
+void pool_run(PoolTask task, void* arg) {
+    if (in_worker || pthread_mutex_trylock(&submit_lock) != 0) {
+        task(arg, 0, 1);
+        return;
+    }
+
+    pthread_mutex_lock(&state_lock);
+    if (!started) {
+        start_pool();
+    }
+    current_task = task;
+    current_arg = arg;
+    pending = thread_count - 1;
+    generation++;
+    int workers = thread_count;
+    pthread_cond_broadcast(&job_ready);
+    pthread_mutex_unlock(&state_lock);
+
+    in_worker = true;
+    task(arg, 0, workers);
+    in_worker = false;
+
+    pthread_mutex_lock(&state_lock);
+    while (pending > 0) {
+        pthread_cond_wait(&job_done, &state_lock);
+    }
+    pthread_mutex_unlock(&state_lock);
+    pthread_mutex_unlock(&submit_lock);
+}
+
+int pool_size(void) {
+    pthread_mutex_lock(&state_lock);
+    if (!started) {
+        start_pool();
+    }
+    int size = thread_count;
+    pthread_mutex_unlock(&state_lock);
+    return size;
+}
+
+void pool_range(int count, int worker, int workers, int* begin, int* end) {
+    *begin = (int)((long long)count * worker / workers);
+    *end = (int)((long long)count * (worker + 1) / workers);
+}
+
+void pool_shutdown(void) {
+    pthread_mutex_lock(&submit_lock);
+    pthread_mutex_lock(&state_lock);
+    stopping = true;
+    pthread_cond_broadcast(&job_ready);
+    pthread_mutex_unlock(&state_lock);
+    for (int t = 1; t < thread_count; t++) {
+        pthread_join(threads[t], NULL);
+    }
+    pthread_mutex_lock(&state_lock);
+    thread_count = 0;
+    started = false;
+    stopping = false;
+    pthread_mutex_unlock(&state_lock);
+    pthread_mutex_unlock(&submit_lock);
+}
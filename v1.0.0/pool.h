@@ -0,0 +1,57 @@
+/**
+ * pool.h - Persistent worker pool for data-parallel loops
+ *
+ * Worker threads are started once and sleep between jobs. A job is a
+ * function that every worker runs with its own worker number; the caller
+ * takes part as worker 0 and pool_run() returns when all workers finish.
+ */
+
+#ifndef POOL_H
+#define POOL_H
+
+// ============= Constants =============
+#define POOL_MAX_THREADS 64        // Upper bound on pool size
+#define POOL_THREADS_ENV "WORDLE_THREADS"  // Environment override of pool size
+
+/**
+ * Job run by every worker
+ * @param arg Shared job argument
+ * @param worker Worker number in [0, workers)
+ * @param workers Number of workers running this job
+ */
+typedef void (*PoolTask)(void* arg, int worker, int workers);
+
+// ============= Pool Functions =============
+
+/**
+ * Runs a job on every worker and waits for it to finish
+ * Starts the pool on first use. When the pool is already busy (another
+ * thread's job, or a call from inside a job) the job runs inline on the
+ * calling thread as a single worker, so results never depend on timing.
+ * @param task Job function
+ * @param arg Argument passed to every worker
+ */
+void pool_run(PoolTask task, void* arg);
+
+/**
+ * Number of workers a job started now would get
+ * @return Pool size including the calling thread
+ */
+int pool_size(void);
+
+/**
+ * Splits [0, count) into equal contiguous ranges, one per worker
+ * @param count Number of items
+ * @param worker Worker number
+ * @param workers Number of workers
+ * @param begin Output, first item of this worker's range
+ * @param end Output, one past the last item
+ */
+void pool_range(int count, int worker, int workers, int* begin, int* end);
+
+/**
+ * Stops and joins the worker threads
+ */
+void pool_shutdown(void);
+
+#endif
@@ -0,0 +1,662 @@
+/**
+ * solver.c - Strategy implementations on explicit solver contexts
+ *
+ * Implements the guess selection of the entropy, minimax, letter
+ * frequency and decision tree strategies. Everything a game needs is in
+ * its SolverContext; the only shared data are the read-only dictionary,
+ * feedback matrix and decision tree.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <pthread.h>
+#include "solver.h"
+#include "feedback.h"
+#include "columns.h"
+#include "pool.h"
+#include "book.h"
+#include "tree.h"
+
+// ============= Constants =============
+#define TREE_OPENER "SALET"     // Opener when no decision tree could be loaded
+#define OFF_TREE_CACHE_SIZE 4096  // Off-tree moves remembered (power of two)
+#define OFF_TREE_PROBES 8         // Slots tried per lookup
+
+// ============= Global Variables =============
+static _Thread_local uint8_t row_scratch[MAX_WORDS];  // Feedback row when there is no matrix
+
+// Decision tree, loaded once and shared read-only
+static DecisionTree decision_tree;
+static pthread_once_t decision_tree_once = PTHREAD_ONCE_INIT;
+
+/**
+ * A move chosen by search after leaving the decision tree
+ */
+typedef struct {
+    uint64_t key1, key2;            // Hashes of the candidate set, both 0 for an empty slot
+    uint32_t guess;                 // Packed move
+} OffTreeEntry;
+
+// Off-tree moves, shared by every context of the tree strategy
+static OffTreeEntry off_tree_cache[OFF_TREE_CACHE_SIZE];
+static pthread_mutex_t off_tree_lock = PTHREAD_MUTEX_INITIALIZER;
+
+/**
+ * Per-worker results of one entropy scan
+ */
+typedef struct {
+    const CandidateSet* set;               // Candidates being split
+    const CandidateSet* pool;              // Guesses allowed, NULL for every word
+    int workers;                           // Number of workers that ran
+    float best_entropy[POOL_MAX_THREADS];  // Best score in each worker's range
+    int best_index[POOL_MAX_THREADS];      // Its wordList index, -1 if none
+} EntropyJob;
+
+// ============= Candidate Helpers =============
+
+/**
+ * Turns the implicit "whole dictionary" set into real bits
+ */
+static void materialize(SolverContext* ctx) {
+    if (ctx->all_candidates) {
+        candidates_fill(&ctx->candidates, wordCount);
+        ctx->all_candidates = false;
+    }
+}
+
+/**
+ * Returns the first remaining candidate
+ * Falls back to the first dictionary word when no candidate is left
+ */
+static const char* first_candidate(const SolverContext* ctx) {
+    if (ctx->all_candidates) return wordList[0];
+    int first = candidates_next(&ctx->candidates, 0);
+    return wordList[first >= 0 ? first : 0];
+}
+
+/**
+ * Tells whether a dictionary word may be guessed
+ * Any word may outside hard mode; in hard mode only words of the pool.
+ */
+static bool allowed_guess(const SolverContext* ctx, int index) {
+    if (!ctx->hard_mode) return true;
+    return index >= 0 && candidates_contains(&ctx->pool, index);
+}
+
+/**
+ * Collects the hard mode guesses for the next move from the pattern index
+ */
+static void select_pool(SolverContext* ctx) {
+    if (ctx->hard_mode) {
+        pattern_match(pattern_words(), &ctx->hints, &ctx->pool);
+    }
+}
+
+/**
+ * Calculates information entropy for a given pattern distribution
+ * @param pattern_counts Array of pattern counts
+ * @param total Number of candidates counted
+ * @return Entropy value
+ */
+static float calculate_entropy(int* pattern_counts, int total) {
+    float entropy = 0.0f;
+    for (int i = 0; i < PATTERN_COUNT; i++) {
+        if (pattern_counts[i] > 0) {
+            float p = (float)pattern_counts[i] / total;
+            entropy -= p * log2f(p);
+        }
+    }
+    return entropy;
+}
+
+/**
+ * Generates pattern counts for a given word
+ * @param set Candidates to count
+ * @param guess Index of the word to evaluate in wordList
+ * @param pattern_counts Output array for pattern counts
+ */
+static void generate_pattern_counts(const CandidateSet* set, int guess, int* pattern_counts) {
+    candidates_histogram(set, feedback_scan(guess, row_scratch), pattern_counts);
+}
+
+// ============= Entropy Strategy =============
+
+/**
+ * Scores one guess for the entropy strategy
+ * @param set Remaining candidates
+ * @param guess Index of the guess in wordList
+ * @param pattern_counts Scratch histogram of PATTERN_COUNT entries
+ * @return Entropy, boosted when the guess is itself a candidate
+ */
+static float score_entropy(const CandidateSet* set, int guess, int* pattern_counts) {
+    generate_pattern_counts(set, guess, pattern_counts);
+    float entropy = calculate_entropy(pattern_counts, set->count);
+
+    // A candidate can also win outright, so its entropy counts double
+    if (candidates_contains(set, guess)) {
+        entropy *= 2.0f;
+    }
+    return entropy;
+}
+
+/**
+ * Pool job: scans one contiguous range of wordList
+ * Each worker keeps its own histogram and its first best word.
+ */
+static void entropy_worker(void* arg, int worker, int workers) {
+    EntropyJob* job = (EntropyJob*)arg;
+    int pattern_counts[PATTERN_COUNT];
+    int begin, end;
+    pool_range(wordCount, worker, workers, &begin, &end);
+
+    float max_entropy = -1.0f;
+    int best_index = -1;
+    for (int i = begin; i < end; i++) {
+        if (job->pool && !candidates_contains(job->pool, i)) continue;
+        float entropy = score_entropy(job->set, i, pattern_counts);
+        if (entropy > max_entropy) {
+            max_entropy = entropy;
+            best_index = i;
+        }
+    }
+    job->best_entropy[worker] = max_entropy;
+    job->best_index[worker] = best_index;
+    if (worker == 0) {
+        job->workers = workers;
+    }
+}
+
+/**
+ * Information entropy based choice
+ * Chooses words that maximize information gain
+ */
+static void choose_entropy(SolverContext* ctx) {
+    float max_entropy = -1.0f;
+
+    if (ctx->candidates.count <= 2) {
+        // When few solutions remain, choose directly from them
+        strcpy(ctx->guess, first_candidate(ctx));
+    } else {
+        // Evaluate all words on the worker pool to find optimal guess
+        EntropyJob job;
+        job.set = &ctx->candidates;
+        job.pool = ctx->hard_mode ? &ctx->pool : NULL;
+        pool_run(entropy_worker, &job);
+
+        // Merge in worker order so ties resolve exactly as a serial scan would
+        int best_index = -1;
+        for (int w = 0; w < job.workers; w++) {
+            if (job.best_index[w] >= 0 && job.best_entropy[w] > max_entropy) {
+                max_entropy = job.best_entropy[w];
+                best_index = job.best_index[w];
+            }
+        }
+
+        strcpy(ctx->guess, best_index >= 0 ? wordList[best_index] : first_candidate(ctx));
+    }
+
+    if (ctx->verbose) {
+        printf("Selected guess: %s (entropy: %.2f)\n", ctx->guess, max_entropy);
+    }
+}
+
+// ============= Minimax Strategy =============
+
+/**
+ * Minimax choice
+ * Minimizes the maximum possible remaining solutions
+ */
+static void choose_minimax(SolverContext* ctx) {
+    int min_worst_case = MAX_WORDS;
+    int pattern_counts[PATTERN_COUNT];
+    const char* best_guess = first_candidate(ctx);
+
+    for (int i = 0; i < wordCount; i++) {
+        if (!allowed_guess(ctx, i)) continue;
+        generate_pattern_counts(&ctx->candidates, i, pattern_counts);
+
+        int max_remaining = 0;
+        for (int j = 0; j < PATTERN_COUNT; j++) {
+            if (pattern_counts[j] > max_remaining) {
+                max_remaining = pattern_counts[j];
+            }
+        }
+
+        if (max_remaining < min_worst_case) {
+            min_worst_case = max_remaining;
+            best_guess = wordList[i];
+        }
+    }
+
+    strcpy(ctx->guess, best_guess);
+}
+
+// ============= Frequency Strategy =============
+
+/**
+ * Letter frequency based choice
+ * Scores position-specific and overall letter frequencies of the candidates
+ */
+static void choose_frequency(SolverContext* ctx) {
+    const CandidateSet* set = &ctx->candidates;
+    const WordColumns* columns = columns_get();
+    if (columns->size != wordCount) {
+        strcpy(ctx->guess, first_candidate(ctx));
+        return;
+    }
+
+    // Calculate letter frequencies, one position column at a time
+    float letter_freq[26][WORD_LENGTH] = {0};
+    float total_freq[26] = {0};
+
+    for (int j = 0; j < WORD_LENGTH; j++) {
+        const uint8_t* column = columns->letter[j];
+        for (int i = candidates_next(set, 0); i >= 0; i = candidates_next(set, i + 1)) {
+            int letter = column[i] - 'A';
+            letter_freq[letter][j]++;
+            total_freq[letter]++;
+        }
+    }
+
+    // Normalize frequencies
+    for (int i = 0; i < 26; i++) {
+        for (int j = 0; j < WORD_LENGTH; j++) {
+            letter_freq[i][j] /= set->count;
+        }
+        total_freq[i] /= (set->count * WORD_LENGTH);
+    }
+
+    // Find best word based on letter frequencies, scoring a block of
+    // words per pass over each column; the terms are added in the same
+    // order as word by word, so scores are bit for bit the same
+    float best_score = -1.0f;
+    int best_index = -1;
+
+    for (int b = 0; b < columns->blocks; b++) {
+        int base = b * COLUMN_BLOCK;
+        int lanes = wordCount - base < COLUMN_BLOCK ? wordCount - base : COLUMN_BLOCK;
+        float score[COLUMN_BLOCK] = {0};
+
+        for (int j = 0; j < WORD_LENGTH; j++) {
+            const uint8_t* column = columns->letter[j] + base;
+            for (int k = 0; k < lanes; k++) {
+                if (!columns->presence[base + k]) continue;   // Not a word
+                int letter = column[k] - 'A';
+                score[k] += letter_freq[letter][j] * 2.0f;  // Position-specific score
+
+                // Overall letter frequency score, for the first copy only
+                bool first = true;
+                for (int e = 0; e < j; e++) {
+                    first = first && columns->letter[e][base + k] != column[k];
+                }
+                if (first) {
+                    score[k] += total_freq[letter];
+                }
+            }
+        }
+
+        for (int k = 0; k < lanes; k++) {
+            if (columns->presence[base + k] && score[k] > best_score &&
+                allowed_guess(ctx, base + k)) {
+                best_score = score[k];
+                best_index = base + k;
+            }
+        }
+    }
+
+    strcpy(ctx->guess, best_index >= 0 ? wordList[best_index] : first_candidate(ctx));
+    if (ctx->verbose) {
+        printf("Selected guess: %s (score: %.2f)\n", ctx->guess, best_score);
+    }
+}
+
+// ============= Decision Tree Strategy =============
+
+/**
+ * Loads the decision tree into the shared node array
+ * Called once through load_decision_tree()
+ */
+static void read_decision_tree(void) {
+    // A compiled tree is mapped as is; otherwise compile the text tree
+    const char* path = TREE_BINARY_FILE;
+    if (!tree_load(&decision_tree, path)) {
+        path = TREE_FILE;
+        if (!tree_load(&decision_tree, path)) {
+            printf("Failed to open %s\n", TREE_FILE);
+            return;
+        }
+    }
+    printf("Loaded decision tree with %d nodes from %s\n", decision_tree.count, path);
+}
+
+/**
+ * Loads the decision tree exactly once, whichever thread asks first
+ */
+static void load_decision_tree(void) {
+    pthread_once(&decision_tree_once, read_decision_tree);
+}
+
+/**
+ * Looks up the move stored for a candidate set
+ * @return true if found; the move is copied to guess
+ */
+static bool off_tree_find(uint64_t key1, uint64_t key2, char guess[WORD_LENGTH + 1]) {
+    bool found = false;
+    pthread_mutex_lock(&off_tree_lock);
+    for (int p = 0; p < OFF_TREE_PROBES; p++) {
+        const OffTreeEntry* entry = &off_tree_cache[(key1 + p) & (OFF_TREE_CACHE_SIZE - 1)];
+        if (entry->key1 == key1 && entry->key2 == key2) {
+            unpackWord(entry->guess, guess);
+            found = true;
+            break;
+        }
+        if (entry->key1 == 0 && entry->key2 == 0) break;
+    }
+    pthread_mutex_unlock(&off_tree_lock);
+    return found;
+}
+
+/**
+ * Stores the move for a candidate set, evicting the first probed slot when full
+ */
+static void off_tree_store(uint64_t key1, uint64_t key2, const char guess[WORD_LENGTH + 1]) {
+    pthread_mutex_lock(&off_tree_lock);
+    OffTreeEntry* slot = &off_tree_cache[key1 & (OFF_TREE_CACHE_SIZE - 1)];
+    for (int p = 0; p < OFF_TREE_PROBES; p++) {
+        OffTreeEntry* entry = &off_tree_cache[(key1 + p) & (OFF_TREE_CACHE_SIZE - 1)];
+        if ((entry->key1 == 0 && entry->key2 == 0) ||
+            (entry->key1 == key1 && entry->key2 == key2)) {
+            slot = entry;
+            break;
+        }
+    }
+    slot->key1 = key1;
+    slot->key2 = key2;
+    slot->guess = packWord(guess);
+    pthread_mutex_unlock(&off_tree_lock);
+}
+
+/**
+ * Off-tree choice
+ * Searches the exact candidate set with the entropy strategy. Moves are
+ * cached by candidate set, so a state reached again costs one lookup;
+ * hard mode moves also depend on the hints and are not cached.
+ * @return true if there is a candidate left and a guess was stored
+ */
+static bool choose_off_tree(SolverContext* ctx) {
+    if (!ctx->use_fallback || ctx->all_candidates || ctx->candidates.count == 0) {
+        return false;
+    }
+    if (ctx->candidates.count <= 2) {
+        strcpy(ctx->guess, first_candidate(ctx));
+        return true;
+    }
+
+    if (ctx->hard_mode) {
+        feedback_init();
+        choose_entropy(ctx);
+        return true;
+    }
+
+    uint64_t key1, key2;
+    candidates_hash(&ctx->candidates, &key1, &key2);
+    if (off_tree_find(key1, key2, ctx->guess)) {
+        if (ctx->verbose) {
+            printf("Selected guess: %s (off-tree cache)\n", ctx->guess);
+        }
+        return true;
+    }
+
+    feedback_init();
+    choose_entropy(ctx);
+    off_tree_store(key1, key2, ctx->guess);
+    return true;
+}
+
+/**
+ * Decision tree choice
+ * Plays the guess of the node reached by the feedback so far, or searches
+ * the remaining candidates once the game has left the tree (in hard mode,
+ * also when the node's guess ignores a hint)
+ * @return true if a move was stored in ctx->guess
+ */
+static bool choose_tree(SolverContext* ctx) {
+    load_decision_tree();
+    char next_word[WORD_LENGTH + 1];
+    if (!tree_guess(&decision_tree, ctx->tree_node, next_word)) {
+        if (ctx->verbose) {
+            printf("No matching move found, searching %d candidates\n",
+                   ctx->candidates.count);
+        }
+        return choose_off_tree(ctx);
+    }
+    if (!allowed_guess(ctx, dictionary_find(packCanonical(next_word)))) {
+        if (ctx->verbose) {
+            printf("Tree move %s breaks hard mode, searching %d candidates\n",
+                   next_word, ctx->candidates.count);
+        }
+        ctx->tree_node = TREE_NONE;
+        return choose_off_tree(ctx);
+    }
+
+    if (ctx->verbose) {
+        printf("Found next word: %s\n", next_word);
+    }
+    strcpy(ctx->guess, next_word);
+    return true;
+}
+
+// ============= Opening Book =============
+
+/**
+ * Tells whether this move is a second guess after the opener
+ * Only then is the state fully described by the opener's feedback code.
+ */
+static bool from_book(const SolverContext* ctx) {
+    return ctx->use_book && !ctx->hard_mode && ctx->turn == 1 && ctx->opener_code >= 0;
+}
+
+// ============= Context Functions =============
+
+void solver_init(SolverContext* ctx, Strategy strategy) {
+    ctx->strategy = strategy;
+    ctx->verbose = false;
+    ctx->use_book = true;
+    ctx->use_fallback = true;
+    ctx->hard_mode = false;
+    solver_new_game(ctx);
+}
+
+SolverContext* solver_create(Strategy strategy) {
+    SolverContext* ctx = (SolverContext*)malloc(sizeof(SolverContext));
+    if (ctx) {
+        solver_init(ctx, strategy);
+    }
+    return ctx;
+}
+
+void solver_destroy(SolverContext* ctx) {
+    free(ctx);
+}
+
+/**
+ * Resets the game state without touching the candidate bits
+ */
+void solver_new_game(SolverContext* ctx) {
+    ctx->all_candidates = true;
+    ctx->candidates.count = wordCount;
+    ctx->turn = 0;
+    ctx->guess[0] = '\0';
+    ctx->opener_code = -1;
+    ctx->tree_node = TREE_ROOT;
+    knowledge_init(&ctx->knowledge);
+    pattern_clear(&ctx->hints);
+}
+
+/**
+ * Chooses the next guess for the context's strategy
+ */
+const char* solver_next_guess(SolverContext* ctx) {
+    if (ctx->strategy == STRATEGY_TREE) {
+        if (ctx->turn == 0) {
+            load_decision_tree();
+            if (!tree_guess(&decision_tree, TREE_ROOT, ctx->guess)) {
+                strcpy(ctx->guess, TREE_OPENER);
+            }
+        } else {
+            if (ctx->verbose) {
+                printf("Current word: %s\n", ctx->guess);
+            }
+            select_pool(ctx);
+            if (!choose_tree(ctx)) return NULL;
+        }
+        ctx->turn++;
+        return ctx->guess;
+    }
+
+    feedback_init();
+    if (ctx->turn > 0 && ctx->verbose && ctx->strategy != STRATEGY_MINIMAX) {
+        printf("Remaining possible solutions: %d\n", ctx->candidates.count);
+    }
+
+    if (ctx->turn > 0 && ctx->candidates.count == 0) {
+        // Feedback contradicted every candidate: start over
+        solver_new_game(ctx);
+    }
+
+    if (ctx->turn == 0) {
+        strcpy(ctx->guess, SOLVER_OPENER);
+    } else if (ctx->candidates.count == 1) {
+        strcpy(ctx->guess, first_candidate(ctx));
+    } else if (from_book(ctx) && book_lookup(ctx->strategy, ctx->opener_code, ctx->guess)) {
+        if (ctx->verbose) {
+            printf("Selected guess: %s (opening book)\n", ctx->guess);
+        }
+    } else {
+        materialize(ctx);
+        select_pool(ctx);
+        switch (ctx->strategy) {
+            case STRATEGY_ENTROPY: choose_entropy(ctx); break;
+            case STRATEGY_MINIMAX: choose_minimax(ctx); break;
+            default: choose_frequency(ctx); break;
+        }
+        if (from_book(ctx)) {
+            book_record(ctx->strategy, ctx->opener_code, ctx->guess);
+        }
+    }
+
+    ctx->turn++;
+    return ctx->guess;
+}
+
+/**
+ * Moves along the tree and the opening book, and collects the hard mode
+ * hints, for one round of feedback
+ */
+static void follow_round(SolverContext* ctx, const char guess[WORD_LENGTH + 1], uint8_t code) {
+    if (ctx->strategy == STRATEGY_TREE) {
+        // Follow the feedback edge; a guess the tree did not suggest leaves it.
+        // A resumed game may get here before any move loaded the tree.
+        load_decision_tree();
+        int node = ctx->tree_node;
+        if (node >= 0 && node < decision_tree.count &&
+            (decision_tree.nodes[node].word & TREE_WORD_MASK) == packWord(guess)) {
+            ctx->tree_node = tree_child(&decision_tree, ctx->tree_node, code);
+        } else {
+            ctx->tree_node = TREE_NONE;
+        }
+        if (ctx->verbose) {
+            char pattern[WORD_LENGTH + 1] = "?????";
+            if (code != PATTERN_INVALID) {
+                decodeFeedback(code, pattern);
+            }
+            printf("Looking for pattern: %s %s%d\n", guess, pattern, ctx->turn);
+        }
+    }
+
+    pattern_add_hints(&ctx->hints, guess, code);
+
+    // Remember the opener's feedback, the key of the opening book
+    ctx->opener_code = -1;
+    if (ctx->turn == 1 && code != PATTERN_INVALID && packWord(guess) == packWord(SOLVER_OPENER)) {
+        ctx->opener_code = code;
+    }
+}
+
+/**
+ * Narrows the candidates with one round of feedback
+ * The matrix row is the cheapest filter when the matrix is built;
+ * otherwise the accumulated constraints are applied to the columns.
+ */
+void solver_observe(SolverContext* ctx, const char guess[WORD_LENGTH + 1], uint8_t code) {
+    follow_round(ctx, guess, code);
+
+    if (code == PATTERN_INVALID) {
+        // Not a real pattern: nothing can match
+        candidates_clear(&ctx->candidates);
+        ctx->all_candidates = false;
+        return;
+    }
+
+    bool known = knowledge_add(&ctx->knowledge, guess, code);
+    int guess_id = word_index(guess);
+    if (known && !(guess_id >= 0 && feedback_ready())) {
+        if (ctx->all_candidates) {
+            knowledge_select(&ctx->knowledge, &ctx->candidates);
+            ctx->all_candidates = false;
+        } else {
+            knowledge_filter(&ctx->knowledge, &ctx->candidates);
+        }
+        return;
+    }
+
+    if (guess_id >= 0) {
+        const uint8_t* row = feedback_scan(guess_id, row_scratch);
+        if (ctx->all_candidates) {
+            candidates_select(&ctx->candidates, row, code, wordCount);
+            ctx->all_candidates = false;
+        } else {
+            candidates_filter(&ctx->candidates, row, code);
+        }
+        return;
+    }
+
+    // Guess outside the dictionary: score the remaining candidates directly
+    materialize(ctx);
+    CandidateSet* set = &ctx->candidates;
+    for (int i = candidates_next(set, 0); i >= 0; i = candidates_next(set, i + 1)) {
+        if (checkWordCode(wordList[i], guess) != code) {
+            candidates_remove(set, i);
+        }
+    }
+}
+
+void solver_resume(SolverContext* ctx, const char (*guesses)[WORD_LENGTH + 1],
+                   const uint8_t* codes, int rounds) {
+    solver_new_game(ctx);
+    Knowledge knowledge;
+    if (rounds == 0 || !knowledge_from_history(&knowledge, guesses, codes, rounds)) {
+        // A round the constraints cannot express: replay the rounds one by one
+        for (int r = 0; r < rounds; r++) {
+            ctx->turn = r + 1;
+            strcpy(ctx->guess, guesses[r]);
+            solver_observe(ctx, guesses[r], codes[r]);
+        }
+        return;
+    }
+
+    for (int r = 0; r < rounds; r++) {
+        ctx->turn = r + 1;
+        strcpy(ctx->guess, guesses[r]);
+        follow_round(ctx, guesses[r], codes[r]);
+    }
+    ctx->knowledge = knowledge;
+    knowledge_select(&ctx->knowledge, &ctx->candidates);
+    ctx->all_candidates = false;
+}
+
+int solver_candidate_count(const SolverContext* ctx) {
+    return ctx->candidates.count;
+}
@@ -0,0 +1,124 @@
+/**
+ * solver.h - Reentrant solver contexts for the Wordle strategies
+ *
+ * All state of one game lives in a SolverContext, so any number of games
+ * can be in flight in one process (one context each). A game is driven
+ * explicitly: solver_new_game(), then solver_next_guess() and
+ * solver_observe() once per round.
+ *
+ * With hard_mode set, searches only consider the words the pattern index
+ * finds for the hints revealed so far. The opening book is skipped (it
+ * holds unrestricted moves) and the tree strategy leaves the tree at the
+ * first move that ignores a hint.
+ */
+
+#ifndef SOLVER_H
+#define SOLVER_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "wordle.h"
+#include "candidates.h"
+#include "knowledge.h"
+#include "pattern.h"
+
+// ============= Constants =============
+#define SOLVER_OPENER "STARE"   // First guess of the searching strategies
+
+/**
+ * Guess selection strategies
+ */
+typedef enum {
+    STRATEGY_ENTROPY,     // Maximize information gain
+    STRATEGY_MINIMAX,     // Minimize the largest remaining partition
+    STRATEGY_FREQUENCY,   // Letter frequency score
+    STRATEGY_TREE         // Follow the precomputed decision tree, then search
+} Strategy;
+
+/**
+ * State of one game
+ */
+typedef struct {
+    Strategy strategy;
+    bool verbose;                    // Print progress like the original players
+    bool use_book;                   // Take the second guess from the opening book
+    bool all_candidates;             // Candidate set is the whole dictionary (not materialized)
+    CandidateSet candidates;         // Remaining possible solutions
+    Knowledge knowledge;             // Constraints from every observation so far
+    int turn;                        // Guesses made so far
+    char guess[WORD_LENGTH + 1];     // Last guess returned, "" if none
+    int opener_code;                 // Feedback for SOLVER_OPENER on turn one, -1 if none
+    int tree_node;                   // Decision tree node to play, TREE_NONE once off the tree
+    bool use_fallback;               // Off the tree, search the candidates instead of giving up
+    bool hard_mode;                  // Every guess must use the greens and yellows revealed
+    PatternQuery hints;              // Greens and yellows revealed so far
+    CandidateSet pool;               // Hard mode guesses allowed by the hints, for this move
+} SolverContext;
+
+// ============= Context Functions =============
+
+/**
+ * Prepares a context for a strategy and starts a game
+ * @param ctx Context to initialize
+ * @param strategy Strategy used by solver_next_guess
+ */
+void solver_init(SolverContext* ctx, Strategy strategy);
+
+/**
+ * Allocates and initializes a context
+ * @param strategy Strategy used by solver_next_guess
+ * @return New context, or NULL on allocation failure
+ */
+SolverContext* solver_create(Strategy strategy);
+
+/**
+ * Frees a context from solver_create
+ * @param ctx Context to free
+ */
+void solver_destroy(SolverContext* ctx);
+
+/**
+ * Starts a new game in O(1)
+ * The candidate set is marked as "whole dictionary" and only
+ * materialized by the first observation.
+ * @param ctx Context to reset
+ */
+void solver_new_game(SolverContext* ctx);
+
+/**
+ * Chooses the next guess
+ * @param ctx Game state
+ * @return Guess owned by the context (valid until the next call), or
+ *         NULL if the strategy has no move
+ */
+const char* solver_next_guess(SolverContext* ctx);
+
+/**
+ * Records the feedback for a guess and narrows the candidates
+ * @param ctx Game state
+ * @param guess Word that was played
+ * @param code Feedback code received for it
+ */
+void solver_observe(SolverContext* ctx, const char guess[WORD_LENGTH + 1], uint8_t code);
+
+/**
+ * Resumes a game from its history in one pass
+ * Leaves the context as if the rounds had been played and observed one
+ * by one (turn, tree position, opening book key), but finds the
+ * candidates with a single constraint scan of the dictionary.
+ * @param ctx Context (a new game is started)
+ * @param guesses Words played, in order
+ * @param codes Feedback received for each
+ * @param rounds Number of rounds played
+ */
+void solver_resume(SolverContext* ctx, const char (*guesses)[WORD_LENGTH + 1],
+                   const uint8_t* codes, int rounds);
+
+/**
+ * Number of remaining candidates
+ * @param ctx Game state
+ * @return Candidate count
+ */
+int solver_candidate_count(const SolverContext* ctx);
+
+#endif
@@ -0,0 +1,626 @@
+/**
+ * tree.c - Decision tree loading, compiling, writing and binary storage
+ *
+ * Both text layouts are read with one token walk: a word token is the
+ * guess at the current level, and a "<PATTERN><LEVEL>" token selects the
+ * child of the guess at that level. Path-per-line files restate every
+ * level on each line; the indented layout starts lines at a pattern and
+ * relies on the guesses remembered from the lines above.
+ *
+ * A binary tree is the TreeFileHeader followed by the node array and the
+ * edge lists of the compact form exactly as they are used in memory.
+ * Compression hash-conses subtrees bottom up: a node's class is decided
+ * by its guess and the classes of its children, then one node is emitted
+ * per class.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "tree.h"
+
+// ============= Constants =============
+#define TREE_MAX_DEPTH 64   // Deepest level a text tree may use
+
+// ============= Node Functions =============
+
+int tree_add_node(DecisionTree* tree, uint32_t word) {
+    if (tree->count == tree->capacity) {
+        int capacity = tree->capacity ? tree->capacity * 2 : 1024;
+        TreeNode* nodes = (TreeNode*)realloc(tree->nodes, capacity * sizeof(TreeNode));
+        if (!nodes) return TREE_NONE;
+        tree->nodes = nodes;
+        tree->capacity = capacity;
+    }
+
+    tree->nodes[tree->count].word = word;
+    tree->nodes[tree->count].table = TREE_EMPTY;
+    return tree->count++;
+}
+
+/**
+ * Gives the parent a table on its first child
+ */
+bool tree_set_child(DecisionTree* tree, int parent, uint8_t code, int child) {
+    if (tree->nodes[parent].table == TREE_EMPTY) {
+        if (tree->table_count == tree->table_capacity) {
+            int capacity = tree->table_capacity ? tree->table_capacity * 2 : 256;
+            TreeTable* tables = (TreeTable*)realloc(tree->tables, capacity * sizeof(TreeTable));
+            if (!tables) return false;
+            tree->tables = tables;
+            tree->table_capacity = capacity;
+        }
+        TreeTable* table = &tree->tables[tree->table_count];
+        for (int c = 0; c < PATTERN_COUNT; c++) {
+            table->child[c] = TREE_EMPTY;
+        }
+        tree->nodes[parent].table = (uint32_t)tree->table_count++;
+    }
+    tree->tables[tree->nodes[parent].table].child[code] = (uint32_t)child;
+    return true;
+}
+
+/**
+ * Copies a subtree, giving up below TREE_MAX_DEPTH
+ * copies maps each source node already copied to its copy, so a shared
+ * node is copied once; it is set only once the node's subtree is done,
+ * so a cycle still runs into the depth limit.
+ */
+static int copy_subtree(DecisionTree* tree, const DecisionTree* source, int node, int depth,
+                        int* copies) {
+    if (copies[node] != TREE_NONE) return copies[node];
+    if (depth > TREE_MAX_DEPTH) return TREE_NONE;
+    int copy = tree_add_node(tree, source->nodes[node].word);
+    if (copy == TREE_NONE) return TREE_NONE;
+    for (int code = 0; code < PATTERN_COUNT; code++) {
+        int child = tree_child(source, node, (uint8_t)code);
+        if (child == TREE_NONE) continue;
+        int child_copy = copy_subtree(tree, source, child, depth + 1, copies);
+        if (child_copy == TREE_NONE || !tree_set_child(tree, copy, (uint8_t)code, child_copy)) {
+            return TREE_NONE;
+        }
+    }
+    copies[node] = copy;
+    return copy;
+}
+
+int tree_copy_subtree(DecisionTree* tree, const DecisionTree* source, int node) {
+    int* copies = (int*)malloc(source->count * sizeof(int));
+    if (!copies) return TREE_NONE;
+    for (int i = 0; i < source->count; i++) {
+        copies[i] = TREE_NONE;
+    }
+    int copy = copy_subtree(tree, source, node, 0, copies);
+    free(copies);
+    return copy;
+}
+
+// ============= DAG Compression =============
+
+/**
+ * Hash-consing state of one tree_compress() call
+ * Classes are the distinct subtrees; class ids are indices into rep.
+ */
+typedef struct {
+    const DecisionTree* tree;
+    int* node_class;      // Class of each source node, -1 until computed
+    int* rep;             // Source node standing for each class
+    int* dag_node;        // Compact node of each class, -1 until emitted
+    int class_count;
+    int* slots;           // Open-addressed class table (class id, -1 empty)
+    int* list_slots;      // Open-addressed edge list table (offset, -1 empty)
+    int slot_mask;        // Both tables have slot_mask + 1 slots
+    bool failed;
+} Compressor;
+
+static uint64_t mix_hash(uint64_t h, uint64_t value) {
+    h ^= value + 0x9E3779B97F4A7C15ULL + (h << 6) + (h >> 2);
+    return h * 0xBF58476D1CE4E5B9ULL;
+}
+
+/**
+ * Tells whether two source nodes of known child classes are the same subtree
+ */
+static bool same_class(const Compressor* c, int a, int b) {
+    if (c->tree->nodes[a].word != c->tree->nodes[b].word) return false;
+    for (int code = 0; code < PATTERN_COUNT; code++) {
+        int child_a = tree_child(c->tree, a, (uint8_t)code);
+        int child_b = tree_child(c->tree, b, (uint8_t)code);
+        int class_a = child_a == TREE_NONE ? -1 : c->node_class[child_a];
+        int class_b = child_b == TREE_NONE ? -1 : c->node_class[child_b];
+        if (class_a != class_b) return false;
+    }
+    return true;
+}
+
+/**
+ * Assigns classes below and at a node, children first
+ */
+static int classify(Compressor* c, int node, int depth) {
+    if (c->node_class[node] >= 0) return c->node_class[node];
+    if (depth > TREE_MAX_DEPTH) {
+        c->failed = true;
+        return 0;
+    }
+
+    uint64_t h = mix_hash(0, c->tree->nodes[node].word);
+    for (int code = 0; code < PATTERN_COUNT && !c->failed; code++) {
+        int child = tree_child(c->tree, node, (uint8_t)code);
+        if (child != TREE_NONE) {
+            h = mix_hash(h, ((uint64_t)code << 32) | (uint32_t)classify(c, child, depth + 1));
+        }
+    }
+    if (c->failed) return 0;
+
+    int slot = (int)(h & (uint64_t)c->slot_mask);
+    while (c->slots[slot] >= 0 && !same_class(c, c->rep[c->slots[slot]], node)) {
+        slot = (slot + 1) & c->slot_mask;
+    }
+    if (c->slots[slot] < 0) {
+        c->rep[c->class_count] = node;
+        c->slots[slot] = c->class_count++;
+    }
+    return c->node_class[node] = c->slots[slot];
+}
+
+/**
+ * Adds an edge list to the compact tree, reusing an identical one
+ * @param list Count followed by the edges
+ * @return Offset of the list, or TREE_EMPTY on allocation failure
+ */
+static uint32_t intern_list(Compressor* c, DecisionTree* dag, const uint32_t* list) {
+    int length = (int)list[0] + 1;
+    uint64_t h = 0;
+    for (int i = 0; i < length; i++) {
+        h = mix_hash(h, list[i]);
+    }
+    int slot = (int)(h & (uint64_t)c->slot_mask);
+    while (c->list_slots[slot] >= 0) {
+        const uint32_t* other = dag->edges + c->list_slots[slot];
+        if (other[0] == list[0] && memcmp(other, list, length * sizeof(uint32_t)) == 0) {
+            return (uint32_t)c->list_slots[slot];
+        }
+        slot = (slot + 1) & c->slot_mask;
+    }
+
+    if (dag->edge_count + length > dag->edge_capacity) {
+        int capacity = dag->edge_capacity ? dag->edge_capacity : 4096;
+        while (capacity < dag->edge_count + length) capacity *= 2;
+        uint32_t* edges = (uint32_t*)realloc(dag->edges, capacity * sizeof(uint32_t));
+        if (!edges) return TREE_EMPTY;
+        dag->edges = edges;
+        dag->edge_capacity = capacity;
+    }
+    memcpy(dag->edges + dag->edge_count, list, length * sizeof(uint32_t));
+    c->list_slots[slot] = dag->edge_count;
+    dag->edge_count += length;
+    return (uint32_t)c->list_slots[slot];
+}
+
+/**
+ * Emits each class once, parents before children, so the root stays TREE_ROOT
+ * @return Compact node of the class of a source node, TREE_NONE on failure
+ */
+static int emit_class(Compressor* c, DecisionTree* dag, int node) {
+    int cls = c->node_class[node];
+    if (c->dag_node[cls] >= 0) return c->dag_node[cls];
+
+    int copy = tree_add_node(dag, c->tree->nodes[node].word);
+    if (copy == TREE_NONE) return TREE_NONE;
+    c->dag_node[cls] = copy;
+
+    uint32_t list[PATTERN_COUNT + 1];
+    list[0] = 0;
+    for (int code = 0; code < PATTERN_COUNT; code++) {
+        int child = tree_child(c->tree, node, (uint8_t)code);
+        if (child == TREE_NONE) continue;
+        int child_copy = emit_class(c, dag, child);
+        if (child_copy == TREE_NONE) return TREE_NONE;
+        list[++list[0]] = ((uint32_t)code << TREE_EDGE_SHIFT) | (uint32_t)child_copy;
+    }
+    if (list[0] > 0) {
+        uint32_t offset = intern_list(c, dag, list);
+        if (offset == TREE_EMPTY) return TREE_NONE;
+        dag->nodes[copy].table = offset;
+    }
+    return copy;
+}
+
+bool tree_compress(DecisionTree* dag, const DecisionTree* tree) {
+    memset(dag, 0, sizeof(*dag));
+    if (tree->count == 0 || (uint32_t)tree->count > TREE_EDGE_CHILD) return false;
+
+    Compressor c;
+    memset(&c, 0, sizeof(c));
+    c.tree = tree;
+    int slots = 1024;
+    while (slots < 2 * tree->count) slots *= 2;
+    c.slot_mask = slots - 1;
+    c.node_class = (int*)malloc(tree->count * sizeof(int));
+    c.rep = (int*)malloc(tree->count * sizeof(int));
+    c.dag_node = (int*)malloc(tree->count * sizeof(int));
+    c.slots = (int*)malloc(slots * sizeof(int));
+    c.list_slots = (int*)malloc(slots * sizeof(int));
+
+    bool ok = c.node_class && c.rep && c.dag_node && c.slots && c.list_slots;
+    if (ok) {
+        memset(c.node_class, -1, tree->count * sizeof(int));
+        memset(c.dag_node, -1, tree->count * sizeof(int));
+        memset(c.slots, -1, slots * sizeof(int));
+        memset(c.list_slots, -1, slots * sizeof(int));
+        classify(&c, TREE_ROOT, 1);
+        ok = !c.failed && emit_class(&c, dag, TREE_ROOT) == TREE_ROOT;
+    }
+
+    free(c.node_class);
+    free(c.rep);
+    free(c.dag_node);
+    free(c.slots);
+    free(c.list_slots);
+    if (!ok) {
+        tree_free(dag);
+    }
+    return ok;
+}
+
+// ============= Measurement =============
+
+/**
+ * Adds the answers solved at and below a node
+ */
+static void measure_node(const DecisionTree* tree, int node, int depth, int max_depth,
+                         TreeStats* stats) {
+    if (depth > TREE_MAX_DEPTH) return;
+    if (tree_solves(tree, node)) {
+        stats->answers++;
+        stats->total_guesses += depth;
+        if (depth > stats->max_depth) stats->max_depth = depth;
+        if (depth > max_depth) stats->failures++;
+    }
+    for (int code = 0; code < PATTERN_COUNT; code++) {
+        int child = tree_child(tree, node, (uint8_t)code);
+        if (child != TREE_NONE) {
+            measure_node(tree, child, depth + 1, max_depth, stats);
+        }
+    }
+}
+
+void tree_measure(const DecisionTree* tree, int max_depth, TreeStats* stats) {
+    memset(stats, 0, sizeof(*stats));
+    if (tree->count > 0) {
+        measure_node(tree, TREE_ROOT, 1, max_depth, stats);
+    }
+}
+
+// ============= Token Functions =============
+
+/**
+ * Checks for a WORD_LENGTH letter word
+ */
+static bool is_word_token(const char* token, size_t length) {
+    if (length != WORD_LENGTH) return false;
+    for (size_t i = 0; i < length; i++) {
+        if (!isalpha((unsigned char)token[i])) return false;
+    }
+    return true;
+}
+
+/**
+ * Parses a "<PATTERN><LEVEL>" token such as "BYBGY3"
+ * @param code Output feedback code
+ * @param level Output guess number the pattern answers (1 = opener)
+ * @return true if the token has that form
+ */
+static bool parse_pattern_token(const char* token, size_t length, uint8_t* code, int* level) {
+    if (length <= WORD_LENGTH) return false;
+
+    char pattern[WORD_LENGTH + 1];
+    memcpy(pattern, token, WORD_LENGTH);
+    pattern[WORD_LENGTH] = '\0';
+    *code = encodeFeedback(pattern);
+    if (*code == PATTERN_INVALID) return false;
+
+    int value = 0;
+    for (size_t i = WORD_LENGTH; i < length; i++) {
+        if (!isdigit((unsigned char)token[i])) return false;
+        value = value * 10 + (token[i] - '0');
+        if (value >= TREE_MAX_DEPTH) return false;
+    }
+    *level = value;
+    return value >= 1;
+}
+
+// ============= Text Trees =============
+
+/**
+ * Walks the tokens of one line
+ * @param level_node Guess node per level, carried across lines
+ * @return false on allocation failure
+ */
+static bool load_line(DecisionTree* tree, char* line, int level_node[TREE_MAX_DEPTH + 1]) {
+    int parent = TREE_NONE;     // Node whose pattern was just read
+    uint8_t parent_code = 0;
+    int parent_level = 0;
+    bool started = false;       // A token of this line has been placed
+
+    char* save = NULL;
+    for (char* token = strtok_r(line, " \t\r\n", &save); token;
+         token = strtok_r(NULL, " \t\r\n", &save)) {
+        size_t length = strlen(token);
+        uint8_t code;
+        int level;
+
+        if (is_word_token(token, length)) {
+            uint32_t word = packWord(token);
+            if (!started) {
+                // A line that starts with a word restates the opener
+                if (tree->count == 0 && tree_add_node(tree, word) == TREE_NONE) return false;
+                if (word != (tree->nodes[TREE_ROOT].word & TREE_WORD_MASK)) return true;
+                level_node[1] = TREE_ROOT;
+                started = true;
+                continue;
+            }
+            if (parent == TREE_NONE) return true;   // Two words in a row
+
+            int child = tree_child(tree, parent, parent_code);
+            if (child == TREE_NONE) {
+                child = tree_add_node(tree, word);
+                if (child == TREE_NONE || !tree_set_child(tree, parent, parent_code, child)) return false;
+            } else if (word != (tree->nodes[child].word & TREE_WORD_MASK)) {
+                return true;   // Conflicts with an earlier path: first one wins
+            }
+            if (parent_level + 1 > TREE_MAX_DEPTH) return true;
+            level_node[parent_level + 1] = child;
+            for (int l = parent_level + 2; l <= TREE_MAX_DEPTH; l++) {
+                level_node[l] = TREE_NONE;
+            }
+            parent = TREE_NONE;
+        } else if (parse_pattern_token(token, length, &code, &level)) {
+            if (level_node[level] == TREE_NONE) return true;   // No guess at that level
+            started = true;
+            if (code == PATTERN_WIN) {
+                tree->nodes[level_node[level]].word |= TREE_SOLVES;
+            }
+            parent = code == PATTERN_WIN ? TREE_NONE : level_node[level];
+            parent_code = code;
+            parent_level = level;
+        } else {
+            return true;   // Not part of a tree: skip the rest of the line
+        }
+    }
+    return true;
+}
+
+/**
+ * Compiles a text tree into allocated arrays
+ */
+static bool load_text(DecisionTree* tree, FILE* file) {
+    int level_node[TREE_MAX_DEPTH + 1];
+    for (int l = 0; l <= TREE_MAX_DEPTH; l++) {
+        level_node[l] = TREE_NONE;
+    }
+
+    char* line = NULL;
+    size_t size = 0;
+    bool ok = true;
+    while (ok && getline(&line, &size, file) != -1) {
+        ok = load_line(tree, line, level_node);
+    }
+    free(line);
+    return ok && tree->count > 0;
+}
+
+/**
+ * Writes the lines of every answer below a node
+ * @param path Text of the guesses and patterns leading to the node
+ * @param order Feedback codes in alphabetical pattern order
+ */
+static void write_paths(FILE* file, const DecisionTree* tree, int node, int level,
+                        char* path, size_t used, const uint8_t order[PATTERN_COUNT]) {
+    char word[WORD_LENGTH + 1];
+    tree_guess(tree, node, word);
+
+    for (int i = 0; i < PATTERN_COUNT; i++) {
+        uint8_t code = order[i];
+        char pattern[WORD_LENGTH + 1];
+        decodeFeedback(code, pattern);
+
+        if (code == PATTERN_WIN) {
+            if (tree_solves(tree, node)) {
+                fprintf(file, "%s%s %s%d\n", path, word, pattern, level);
+            }
+            continue;
+        }
+
+        int child = tree_child(tree, node, code);
+        if (child == TREE_NONE || level >= TREE_MAX_DEPTH) continue;
+        int length = sprintf(path + used, "%s %s%d ", word, pattern, level);
+        write_paths(file, tree, child, level + 1, path, used + length, order);
+        path[used] = '\0';
+    }
+}
+
+bool tree_write_text(const DecisionTree* tree, FILE* file) {
+    if (tree->count == 0) return false;
+
+    // Siblings are listed by pattern text, where B < G < Y
+    uint8_t order[PATTERN_COUNT];
+    char patterns[PATTERN_COUNT][WORD_LENGTH + 1];
+    for (int code = 0; code < PATTERN_COUNT; code++) {
+        decodeFeedback((uint8_t)code, patterns[code]);
+        int i = code;
+        while (i > 0 && strcmp(patterns[order[i - 1]], patterns[code]) > 0) {
+            order[i] = order[i - 1];
+            i--;
+        }
+        order[i] = (uint8_t)code;
+    }
+
+    char line[TREE_MAX_DEPTH * (2 * WORD_LENGTH + 5) + 1] = "";
+    write_paths(file, tree, TREE_ROOT, 1, line, 0, order);
+    return !ferror(file);
+}
+
+bool tree_save_text(const DecisionTree* tree, const char* path) {
+    if (tree->count == 0) return false;
+
+    char temp_name[256];
+    snprintf(temp_name, sizeof(temp_name), "%s.%ld.tmp", path, (long)getpid());
+    FILE* file = fopen(temp_name, "w");
+    if (!file) return false;
+
+    bool ok = tree_write_text(tree, file);
+    ok = (fclose(file) == 0) && ok;
+    if (!ok || rename(temp_name, path) != 0) {
+        remove(temp_name);
+        return false;
+    }
+    return true;
+}
+
+// ============= Binary Trees =============
+
+/**
+ * Checks that every edge list of a compact tree lies inside the edge
+ * words, is sorted by code and points at existing nodes
+ */
+static bool valid_edges(const DecisionTree* tree) {
+    for (int i = 0; i < tree->count; i++) {
+        uint32_t table = tree->nodes[i].table;
+        if (table == TREE_EMPTY) continue;
+        if (table >= (uint32_t)tree->edge_count ||
+            tree->edges[table] > (uint32_t)tree->edge_count - table - 1) {
+            return false;
+        }
+        const uint32_t* list = tree->edges + table + 1;
+        for (uint32_t e = 0; e < tree->edges[table]; e++) {
+            uint32_t code = list[e] >> TREE_EDGE_SHIFT;
+            if (code >= PATTERN_COUNT || (list[e] & TREE_EDGE_CHILD) >= (uint32_t)tree->count ||
+                (e > 0 && code <= list[e - 1] >> TREE_EDGE_SHIFT)) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+/**
+ * Maps a binary tree read-only
+ * The file must be exactly as long as its header says.
+ */
+static bool map_binary(DecisionTree* tree, const char* path) {
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) return false;
+
+    struct stat st;
+    TreeFileHeader header;
+    if (fstat(fd, &st) != 0 || st.st_size < (off_t)sizeof(header) ||
+        pread(fd, &header, sizeof(header), 0) != (ssize_t)sizeof(header)) {
+        close(fd);
+        return false;
+    }
+
+    size_t length = sizeof(header) + (size_t)header.node_count * sizeof(TreeNode) +
+                    (size_t)header.edge_count * sizeof(uint32_t);
+    if (memcmp(header.magic, TREE_MAGIC, sizeof(header.magic)) != 0 ||
+        header.version != TREE_VERSION || header.word_length != WORD_LENGTH ||
+        header.node_count == 0 || header.node_count >= TREE_EMPTY ||
+        (size_t)st.st_size != length) {
+        close(fd);
+        return false;
+    }
+
+    void* base = mmap(NULL, length, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (base == MAP_FAILED) return false;
+
+    tree->mapping = base;
+    tree->mapping_length = length;
+    tree->nodes = (TreeNode*)((char*)base + sizeof(header));
+    tree->edges = (uint32_t*)(tree->nodes + header.node_count);
+    tree->count = (int)header.node_count;
+    tree->edge_count = (int)header.edge_count;
+    return valid_edges(tree);
+}
+
+bool tree_save_binary(const DecisionTree* tree, const char* path) {
+    if (tree->tables) {
+        DecisionTree compact;
+        if (!tree_compress(&compact, tree)) return false;
+        bool ok = tree_save_binary(&compact, path);
+        tree_free(&compact);
+        return ok;
+    }
+
+    char temp_name[256];
+    snprintf(temp_name, sizeof(temp_name), "%s.%ld.tmp", path, (long)getpid());
+
+    FILE* file = fopen(temp_name, "wb");
+    if (!file) return false;
+
+    TreeFileHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, TREE_MAGIC, sizeof(header.magic));
+    header.version = TREE_VERSION;
+    header.word_length = WORD_LENGTH;
+    header.node_count = (uint32_t)tree->count;
+    header.edge_count = (uint32_t)tree->edge_count;
+
+    bool ok = fwrite(&header, sizeof(header), 1, file) == 1 &&
+              fwrite(tree->nodes, sizeof(TreeNode), tree->count, file) == (size_t)tree->count &&
+              fwrite(tree->edges, sizeof(uint32_t), tree->edge_count, file) ==
+                  (size_t)tree->edge_count;
+    ok = (fclose(file) == 0) && ok;
+    if (!ok || rename(temp_name, path) != 0) {
+        remove(temp_name);
+        return false;
+    }
+    return true;
+}
+
+// ============= Tree Functions =============
+
+bool tree_load(DecisionTree* tree, const char* path) {
+    memset(tree, 0, sizeof(*tree));
+
+    FILE* file = fopen(path, "r");
+    if (!file) return false;
+
+    char magic[sizeof(TREE_MAGIC) - 1];
+    bool binary = fread(magic, 1, sizeof(magic), file) == sizeof(magic) &&
+                  memcmp(magic, TREE_MAGIC, sizeof(magic)) == 0;
+    bool ok;
+    if (binary) {
+        fclose(file);
+        ok = map_binary(tree, path);
+    } else {
+        // Compile the text into a tree being built, then keep its compact form
+        DecisionTree built;
+        memset(&built, 0, sizeof(built));
+        rewind(file);
+        ok = load_text(&built, file) && tree_compress(tree, &built);
+        fclose(file);
+        tree_free(&built);
+    }
+
+    if (!ok) {
+        tree_free(tree);
+    }
+    return ok;
+}
+
+void tree_free(DecisionTree* tree) {
+    if (tree->mapping) {
+        munmap(tree->mapping, tree->mapping_length);
+    } else {
+        free(tree->nodes);
+        free(tree->tables);
+        free(tree->edges);
+    }
+    memset(tree, 0, sizeof(*tree));
+}
@@ -0,0 +1,262 @@
+/**
+ * tree.h - Compiled decision tree index
+ *
+ * A decision tree is an array of fixed-size nodes. Each node holds its
+ * guess as a packed word and, unless it is a leaf, where to find its
+ * children by feedback code. A tree being built gives every inner node a
+ * full child table, so children can be set in any order.
+ *
+ * Loaded trees are compact (tree_compress()): identical subtrees are
+ * merged into one, making the tree a DAG sized by its distinct states,
+ * and each node's children are a short list of the codes it actually
+ * has, found by binary search. Identical lists are stored once.
+ *
+ * The compact arrays are stored in the binary format (TREE_BINARY_FILE),
+ * which is mapped read-only and used in place with no parsing. Text trees
+ * (tree_u.txt, tree_l.txt and the indented tree_base.txt) are compiled
+ * into them at load time; words are matched in upper case.
+ */
+
+#ifndef TREE_H
+#define TREE_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include "wordle.h"
+
+// ============= Constants =============
+#define TREE_FILE "tree_u.txt"          // Text tree played by the decision tree strategy
+#define TREE_BINARY_FILE "tree.bin"     // Compiled tree, preferred when present
+#define TREE_ROOT 0                     // Index of the opener's node
+#define TREE_NONE (-1)                  // No node (feedback not covered by the tree)
+#define TREE_EMPTY 0xFFFFFFFFu          // TREE_NONE as stored in nodes and tables
+#define TREE_SOLVES 0x80000000u         // Node flag: the guess itself may be the answer
+#define TREE_WORD_MASK ((1u << PACKED_WORD_BITS) - 1)
+
+#define TREE_EDGE_SHIFT 24               // Compact edge: code << TREE_EDGE_SHIFT | child
+#define TREE_EDGE_CHILD ((1u << TREE_EDGE_SHIFT) - 1)
+
+#define TREE_MAGIC "WTREEBIN"           // First 8 bytes of a binary tree
+#define TREE_VERSION 3
+
+/**
+ * One guess of the tree (8 bytes)
+ */
+typedef struct {
+    uint32_t word;     // Guess, packWord() format, plus TREE_SOLVES
+    uint32_t table;    // Child table index (or edge list offset if compact), TREE_EMPTY for a leaf
+} TreeNode;
+
+/**
+ * Children of one node of a tree being built, indexed by feedback code
+ */
+typedef struct {
+    uint32_t child[PATTERN_COUNT];   // Node index, TREE_EMPTY if the code is not covered
+} TreeTable;
+
+/**
+ * Header of a binary tree file; nodes follow it, then the edge lists
+ * Every inner node's table field is the offset of its list in the edge
+ * words: a count k, then k edges in increasing code order.
+ */
+typedef struct {
+    char magic[8];           // TREE_MAGIC
+    uint32_t version;        // TREE_VERSION
+    uint32_t word_length;    // WORD_LENGTH the file was written for
+    uint32_t node_count;
+    uint32_t edge_count;     // 32-bit words of edge lists
+    uint32_t reserved[2];    // Zero
+} TreeFileHeader;
+
+/**
+ * Quality of a tree over the answers it solves
+ */
+typedef struct {
+    int answers;          // Answers the tree solves (GGGGG lines)
+    long total_guesses;   // Sum of the guesses needed for each answer
+    int max_depth;        // Most guesses any answer needs
+    int failures;         // Answers needing more than the allowed guesses
+} TreeStats;
+
+/**
+ * Node and child arrays of a whole tree; nodes[TREE_ROOT] is the opener
+ * A tree being built uses tables, a compact (loaded) one uses edges.
+ */
+typedef struct {
+    TreeNode* nodes;
+    TreeTable* tables;       // Child tables while building, NULL when compact
+    uint32_t* edges;         // Edge lists when compact, NULL while building
+    int count;               // Number of nodes
+    int table_count;
+    int edge_count;          // Words in edges
+    int capacity;            // Allocated nodes (0 when mapped)
+    int table_capacity;      // Allocated tables (0 when mapped)
+    int edge_capacity;       // Allocated edge words (0 when mapped)
+    void* mapping;           // Mapped binary file, NULL otherwise
+    size_t mapping_length;
+} DecisionTree;
+
+// ============= Tree Functions =============
+
+/**
+ * Loads a decision tree file of any supported format
+ * The result is compact. A binary tree is mapped read-only. Text trees
+ * are compiled and then compressed: both lines
+ * of "<WORD> <PATTERN><LEVEL> ..." paths and the indented layout, where a
+ * line continues the path of the lines above, are accepted. When two
+ * paths disagree on a guess, the first one wins.
+ * @param tree Tree to fill (overwritten)
+ * @param path File to read
+ * @return true if the file was read and has at least one node
+ */
+bool tree_load(DecisionTree* tree, const char* path);
+
+/**
+ * Writes a tree in the tree_u.txt format
+ * One line per answer, "<WORD> <PATTERN><LEVEL> ... <WORD> GGGGG<LEVEL>",
+ * with siblings in alphabetical pattern order.
+ * @param tree Loaded tree
+ * @param path Output file
+ * @return true if the file was written
+ */
+bool tree_save_text(const DecisionTree* tree, const char* path);
+
+/**
+ * Writes the tree_u.txt lines of a tree to an open file
+ * @param tree Loaded tree
+ * @param file Output stream
+ * @return true if nothing failed
+ */
+bool tree_write_text(const DecisionTree* tree, FILE* file);
+
+/**
+ * Writes a tree in the binary format
+ * A tree that is not compact yet is compressed first. Goes through a
+ * temporary file, so readers never map a partial tree.
+ * @param tree Loaded or built tree
+ * @param path Output file
+ * @return true if the file was written
+ */
+bool tree_save_binary(const DecisionTree* tree, const char* path);
+
+/**
+ * Appends a node with no children to an allocated tree
+ * The first node added becomes TREE_ROOT.
+ * @param tree Tree being built (not a loaded one)
+ * @param word Packed guess, optionally with TREE_SOLVES
+ * @return Index of the new node, or TREE_NONE on allocation failure
+ */
+int tree_add_node(DecisionTree* tree, uint32_t word);
+
+/**
+ * Links a child under one feedback code of a node
+ * @param tree Tree being built (not a loaded one)
+ * @param parent Parent node
+ * @param code Feedback code (not PATTERN_WIN)
+ * @param child Child node
+ * @return false on allocation failure
+ */
+bool tree_set_child(DecisionTree* tree, int parent, uint8_t code, int child);
+
+/**
+ * Copies the subtree below a node of another tree
+ * Shared nodes of a DAG (a loaded compact tree) are copied once and stay
+ * shared in the copy, so the copy is no larger than the source.
+ * @param tree Tree being built (not a loaded one)
+ * @param source Tree to copy from
+ * @param node Root of the subtree in source
+ * @return Index of the copy of node, or TREE_NONE on allocation failure
+ *         or if a path is deeper than a tree can be (a cyclic source)
+ */
+int tree_copy_subtree(DecisionTree* tree, const DecisionTree* source, int node);
+
+/**
+ * Builds the compact form of a tree
+ * Two nodes are merged when they hold the same guess (and TREE_SOLVES)
+ * and their children under every code are merged nodes; nodes with
+ * different guesses but the same children share one edge list. Nodes
+ * are numbered parents first, so the opener stays TREE_ROOT. The result
+ * answers tree_child(), tree_guess() and every writer exactly as the
+ * source does, and the source may itself be compact.
+ * @param dag Output (overwritten; free with tree_free)
+ * @param tree Loaded or built tree
+ * @return false on allocation failure or a tree too large to encode
+ */
+bool tree_compress(DecisionTree* dag, const DecisionTree* tree);
+
+/**
+ * Measures the guesses needed for every answer of a tree
+ * @param tree Loaded tree
+ * @param max_depth Guesses allowed; deeper answers count as failures
+ * @param stats Output statistics
+ */
+void tree_measure(const DecisionTree* tree, int max_depth, TreeStats* stats);
+
+/**
+ * Follows one feedback code
+ * @param tree Loaded tree
+ * @param node Current node
+ * @param code Feedback received for the node's guess
+ * @return Child node, or TREE_NONE if the tree does not cover the code
+ */
+static inline int tree_child(const DecisionTree* tree, int node, uint8_t code) {
+    if (node < 0 || node >= tree->count || code >= PATTERN_COUNT) return TREE_NONE;
+    uint32_t table = tree->nodes[node].table;
+    uint32_t child = TREE_EMPTY;
+    if (tree->edges) {
+        // Binary search of the edge list, sorted by code
+        if (table >= (uint32_t)tree->edge_count) return TREE_NONE;
+        const uint32_t* list = tree->edges + table + 1;
+        int low = 0, high = (int)tree->edges[table] - 1;
+        while (low <= high) {
+            int mid = (low + high) / 2;
+            uint32_t mid_code = list[mid] >> TREE_EDGE_SHIFT;
+            if (mid_code == code) {
+                child = list[mid] & TREE_EDGE_CHILD;
+                break;
+            }
+            if (mid_code < code) {
+                low = mid + 1;
+            } else {
+                high = mid - 1;
+            }
+        }
+    } else {
+        if (table >= (uint32_t)tree->table_count) return TREE_NONE;
+        child = tree->tables[table].child[code];
+    }
+    return child < (uint32_t)tree->count ? (int)child : TREE_NONE;
+}
+
+/**
+ * Guess stored at a node
+ * @param tree Loaded tree
+ * @param node Node index
+ * @param guess Output buffer for the upper case guess
+ * @return false for TREE_NONE
+ */
+static inline bool tree_guess(const DecisionTree* tree, int node, char guess[WORD_LENGTH + 1]) {
+    if (node < 0 || node >= tree->count) return false;
+    unpackWord(tree->nodes[node].word & TREE_WORD_MASK, guess);
+    return true;
+}
+
+/**
+ * Tells whether a node's guess can be the answer (the tree has a GGGGG line)
+ * @param tree Loaded tree
+ * @param node Node index
+ * @return true if the node carries TREE_SOLVES
+ */
+static inline bool tree_solves(const DecisionTree* tree, int node) {
+    return node >= 0 && node < tree->count && (tree->nodes[node].word & TREE_SOLVES);
+}
+
+/**
+ * Releases the arrays or the mapping
+ * @param tree Tree to release (left empty)
+ */
+void tree_free(DecisionTree* tree);
+
+#endif
@@ -0,0 +1,238 @@
+/**
+ * tree_build.c - Decision tree generator
+ *
+ * Builds a decision tree for solutionList.txt from an opener, using the
+ * whole of wordList.txt as guesses, and writes it in the tree_u.txt
+ * format (or the binary format if the output name ends in ".bin").
+ * With --exact the tree minimizing the total guesses is searched instead.
+ * With --repair an existing tree is patched for a changed answer list:
+ * the answers are solutionList.txt, or, with --add/--remove, the answers
+ * of the old tree plus and minus the words in those files.
+ *
+ * Usage: ./tree_build [--beam N] [--depth N] [--words FILE]
+ *                     [--solutions FILE] [--opener WORD] [OUTPUT]
+ *        ./tree_build --exact [--guesses N] [--checkpoint FILE]
+ *                     [--depth N] [...] [--opener WORD] [OUTPUT]
+ *        ./tree_build --repair TREE [--add FILE] [--remove FILE]
+ *                     [--beam N] [--depth N] [...] [OUTPUT]
+ *        defaults: beam 1 (greedy entropy), depth MAX_ROUNDS,
+ *                  all guesses, SALET, tree_gen.txt
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <time.h>
+#include "wordle.h"
+#include "feedback.h"
+#include "candidates.h"
+#include "pool.h"
+#include "builder.h"
+#include "optimal.h"
+
+/**
+ * Wall clock time in seconds
+ */
+static double now_seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+/**
+ * Marks the dictionary words listed in a file, one per line
+ * Words not in the dictionary are reported and skipped.
+ * @return false if the file cannot be read
+ */
+static bool read_word_file(const char* path, CandidateSet* set) {
+    FILE* file = fopen(path, "r");
+    if (!file) {
+        fprintf(stderr, "Failed to open %s\n", path);
+        return false;
+    }
+    char line[64];
+    while (fgets(line, sizeof(line), file)) {
+        char word[WORD_LENGTH + 1];
+        int length = 0;
+        for (int i = 0; line[i] && !isspace((unsigned char)line[i]) && length <= WORD_LENGTH; i++) {
+            word[length++] = line[i];
+        }
+        if (length == 0) continue;
+        word[length < WORD_LENGTH ? length : WORD_LENGTH] = '\0';
+        int index = length == WORD_LENGTH ? dictionary_find(packWord(word)) : -1;
+        if (index < 0) {
+            fprintf(stderr, "Skipping %s in %s: not in the dictionary\n", word, path);
+        } else {
+            candidates_add(set, index);
+        }
+    }
+    fclose(file);
+    return true;
+}
+
+/**
+ * Tells whether a file name ends with a suffix
+ */
+static int ends_with(const char* name, const char* suffix) {
+    size_t length = strlen(name), suffix_length = strlen(suffix);
+    return length >= suffix_length && strcmp(name + length - suffix_length, suffix) == 0;
+}
+
+int main(int argc, char** argv) {
+    BuilderOptions options;
+    builder_default_options(&options);
+    OptimalOptions exact_options;
+    optimal_default_options(&exact_options);
+    bool exact = false;
+    const char* repair_file = NULL;
+    const char* add_file = NULL;
+    const char* remove_file = NULL;
+    const char* words_file = "wordList.txt";
+    const char* solutions_file = "solutionList.txt";
+    char opener[WORD_LENGTH + 1] = BUILDER_OPENER;
+    const char* output = "tree_gen.txt";
+
+    bool has_output = false;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--beam") == 0 && i + 1 < argc) {
+            options.beam_width = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--depth") == 0 && i + 1 < argc) {
+            options.max_depth = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--exact") == 0) {
+            exact = true;
+        } else if (strcmp(argv[i], "--guesses") == 0 && i + 1 < argc) {
+            exact_options.guess_limit = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--checkpoint") == 0 && i + 1 < argc) {
+            exact_options.checkpoint = argv[++i];
+        } else if (strcmp(argv[i], "--repair") == 0 && i + 1 < argc) {
+            repair_file = argv[++i];
+        } else if (strcmp(argv[i], "--add") == 0 && i + 1 < argc) {
+            add_file = argv[++i];
+        } else if (strcmp(argv[i], "--remove") == 0 && i + 1 < argc) {
+            remove_file = argv[++i];
+        } else if (strcmp(argv[i], "--words") == 0 && i + 1 < argc) {
+            words_file = argv[++i];
+        } else if (strcmp(argv[i], "--solutions") == 0 && i + 1 < argc) {
+            solutions_file = argv[++i];
+        } else if (strcmp(argv[i], "--opener") == 0 && i + 1 < argc) {
+            const char* word = argv[++i];
+            if (strlen(word) != WORD_LENGTH) {
+                fprintf(stderr, "Opener must have %d letters: %s\n", WORD_LENGTH, word);
+                return 1;
+            }
+            for (int j = 0; j < WORD_LENGTH; j++) {
+                opener[j] = (char)toupper((unsigned char)word[j]);
+            }
+        } else if (!has_output) {
+            output = argv[i];
+            has_output = true;
+        } else {
+            fprintf(stderr, "Unexpected argument: %s\n", argv[i]);
+            return 1;
+        }
+    }
+    if (options.beam_width < 1 || options.beam_width > BUILDER_MAX_BEAM || options.max_depth < 1) {
+        fprintf(stderr, "Beam width must be 1-%d and depth at least 1\n", BUILDER_MAX_BEAM);
+        return 1;
+    }
+    exact_options.max_depth = options.max_depth;
+
+    loadWords(words_file);
+    loadSolution(solutions_file);
+    if (word_index(opener) < 0) {
+        fprintf(stderr, "Opener %s is not in %s\n", opener, words_file);
+        return 1;
+    }
+
+    DecisionTree old;
+    if (repair_file && !tree_load(&old, repair_file)) {
+        fprintf(stderr, "Failed to load decision tree from %s\n", repair_file);
+        return 1;
+    }
+
+    // Answers as wordList indices, without repeats
+    CandidateSet seen;
+    candidates_clear(&seen);
+    int* answers = (int*)malloc(MAX_WORDS * sizeof(int));
+    int count = 0;
+    if (repair_file && (add_file || remove_file)) {
+        // The old tree's answers, changed by the lists
+        for (int i = 0; i < old.count; i++) {
+            int index = tree_solves(&old, i) ? dictionary_find(old.nodes[i].word & TREE_WORD_MASK) : -1;
+            if (index >= 0) candidates_add(&seen, index);
+        }
+        CandidateSet removed;
+        candidates_clear(&removed);
+        if ((add_file && !read_word_file(add_file, &seen)) ||
+            (remove_file && !read_word_file(remove_file, &removed))) {
+            free(answers);
+            return 1;
+        }
+        for (int i = candidates_next(&removed, 0); i >= 0; i = candidates_next(&removed, i + 1)) {
+            if (candidates_contains(&seen, i)) candidates_remove(&seen, i);
+        }
+        for (int i = candidates_next(&seen, 0); answers && i >= 0; i = candidates_next(&seen, i + 1)) {
+            answers[count++] = i;
+        }
+    } else {
+        for (int i = 0; answers && i < solutionCount; i++) {
+            int index = dictionary_find(solutionPacked[i]);
+            if (index < 0) {
+                fprintf(stderr, "Skipping %s: not in %s\n", solutionList[i], words_file);
+            } else if (!candidates_contains(&seen, index)) {
+                candidates_add(&seen, index);
+                answers[count++] = index;
+            }
+        }
+    }
+
+    if (repair_file) {
+        printf("Repairing %s (%d nodes) for %d answers (beam %d, depth %d)\n",
+               repair_file, old.count, count, options.beam_width, options.max_depth);
+    } else if (exact) {
+        printf("Searching the optimal tree from %s for %d answers (depth %d, %s) on %d threads\n",
+               opener, count, options.max_depth,
+               exact_options.guess_limit ? "best guesses only" : "all guesses", pool_size());
+    } else {
+        printf("Building tree from %s for %d answers (beam %d, depth %d) on %d threads\n",
+               opener, count, options.beam_width, options.max_depth, pool_size());
+    }
+    double start = now_seconds();
+
+    DecisionTree tree;
+    TreeStats stats;
+    int rebuilt = 0;
+    bool built = answers &&
+                 (repair_file ? builder_repair(&tree, &old, answers, count, &options, &stats, &rebuilt)
+                  : exact ? optimal_build(&tree, opener, answers, count, &exact_options, &stats)
+                          : builder_build(&tree, opener, answers, count, &options, &stats));
+    if (repair_file) {
+        tree_free(&old);
+    }
+    if (!built) {
+        fprintf(stderr, "Failed to build the tree\n");
+        free(answers);
+        return 1;
+    }
+
+    printf("Built %d nodes in %.2f seconds\n", tree.count, now_seconds() - start);
+    if (repair_file) {
+        printf("Generated %d new subtrees; the rest of %s was kept\n", rebuilt, repair_file);
+    }
+    printf("Average guesses: %.4f, worst case: %d, failures: %d\n",
+           stats.answers ? (double)stats.total_guesses / stats.answers : 0.0,
+           stats.max_depth, stats.failures);
+
+    bool ok = ends_with(output, ".bin") ? tree_save_binary(&tree, output)
+                                        : tree_save_text(&tree, output);
+    if (!ok) {
+        fprintf(stderr, "Failed to write %s\n", output);
+    } else {
+        printf("Wrote %s\n", output);
+    }
+
+    tree_free(&tree);
+    free(answers);
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,321 @@
+/**
+ * tree_check.c - Decision tree validator and statistics
+ *
+ * Replays every word of solutionList.txt through a decision tree on the
+ * worker pool, the way player_AI would play it in wordle(), and reports:
+ *   - coverage gaps: solutions reaching feedback the tree has no move for,
+ *     or not found within the guess limit
+ *   - illegal guesses: tree words missing from wordList.txt; wordle()
+ *     rejects them, so a solution reaching one is not solved
+ *   - dangling paths: branches no solution reaches, and GGGGG lines for
+ *     words that are not solutions
+ *   - the guess distribution, average and worst case, and the expected
+ *     score under wordle()'s 10 - i scoring
+ * The exit status is 0 only if every solution is solved with legal
+ * guesses, every answer has its GGGGG line and nothing dangles.
+ *
+ * Usage: ./tree_check [--words FILE] [--solutions FILE] [--depth N] [TREE]
+ *        defaults: wordList.txt solutionList.txt MAX_ROUNDS tree_u.txt
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "wordle.h"
+#include "feedback.h"
+#include "candidates.h"
+#include "pool.h"
+#include "tree.h"
+
+// ============= Constants =============
+#define REPORT_LIMIT 10     // Problems of each kind listed in full
+
+/**
+ * How the replay of one solution ended
+ */
+typedef enum {
+    REPLAY_SOLVED,       // Guessed within the limit
+    REPLAY_GAP,          // The tree has no move for the feedback received
+    REPLAY_ILLEGAL,      // The tree plays a word missing from wordList
+    REPLAY_TOO_DEEP      // Still unsolved when the guesses ran out
+} ReplayStatus;
+
+/**
+ * Replay of one solution
+ */
+typedef struct {
+    ReplayStatus status;
+    int guesses;         // Guesses made (the winning one included when solved)
+    int node;            // Last node played
+    uint8_t code;        // Feedback received there, for a gap
+    bool unmarked;       // Solved at a node without a GGGGG line
+} Replay;
+
+/**
+ * Shared state of the pool jobs
+ */
+typedef struct {
+    const DecisionTree* tree;
+    int max_depth;
+    bool* legal;         // Per node: its guess is in wordList
+    uint8_t* reached;    // Per node: some solution played it
+    Replay* replays;     // Per solutionList entry
+} CheckRun;
+
+/**
+ * Wall clock time in seconds
+ */
+static double now_seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+// ============= Replay =============
+
+/**
+ * Pool job: checks the guess of each node in this worker's range
+ */
+static void legal_worker(void* arg, int worker, int workers) {
+    CheckRun* run = (CheckRun*)arg;
+    int begin, end;
+    pool_range(run->tree->count, worker, workers, &begin, &end);
+    for (int i = begin; i < end; i++) {
+        run->legal[i] = dictionary_find(run->tree->nodes[i].word & TREE_WORD_MASK) >= 0;
+    }
+}
+
+/**
+ * Pool job: replays the solutions in this worker's range
+ */
+static void replay_worker(void* arg, int worker, int workers) {
+    CheckRun* run = (CheckRun*)arg;
+    int begin, end;
+    pool_range(solutionCount, worker, workers, &begin, &end);
+
+    for (int s = begin; s < end; s++) {
+        Replay* r = &run->replays[s];
+        memset(r, 0, sizeof(*r));
+        int node = TREE_ROOT;
+        for (;;) {
+            __atomic_store_n(&run->reached[node], 1, __ATOMIC_RELAXED);
+            r->node = node;
+            r->guesses++;
+            if (!run->legal[node]) {
+                // wordle() rejects the guess and player_AI has no other move
+                r->status = REPLAY_ILLEGAL;
+                break;
+            }
+
+            char word[WORD_LENGTH + 1];
+            tree_guess(run->tree, node, word);
+            uint8_t code = checkWordCode(solutionList[s], word);
+            if (code == PATTERN_WIN) {
+                r->status = r->guesses <= run->max_depth ? REPLAY_SOLVED : REPLAY_TOO_DEEP;
+                r->unmarked = !tree_solves(run->tree, node);
+                break;
+            }
+            int child = tree_child(run->tree, node, code);
+            if (child == TREE_NONE) {
+                r->status = REPLAY_GAP;
+                r->code = code;
+                break;
+            }
+            if (r->guesses >= run->max_depth) {
+                r->status = REPLAY_TOO_DEEP;
+                break;
+            }
+            node = child;
+        }
+    }
+}
+
+// ============= Reporting =============
+
+/**
+ * Records the first path found to every node
+ */
+static void find_parents(const DecisionTree* tree, int* parent, uint8_t* parent_code) {
+    int* queue = (int*)malloc(tree->count * sizeof(int));
+    for (int i = 0; i < tree->count; i++) {
+        parent[i] = TREE_NONE;
+    }
+    if (!queue) return;
+    int head = 0, tail = 0;
+    queue[tail++] = TREE_ROOT;
+    parent[TREE_ROOT] = TREE_ROOT;
+    while (head < tail) {
+        int node = queue[head++];
+        for (int code = 0; code < PATTERN_COUNT; code++) {
+            int child = tree_child(tree, node, (uint8_t)code);
+            if (child != TREE_NONE && parent[child] == TREE_NONE) {
+                parent[child] = node;
+                parent_code[child] = (uint8_t)code;
+                queue[tail++] = child;
+            }
+        }
+    }
+    free(queue);
+}
+
+/**
+ * Prints the guesses and patterns leading to a node, in the tree_u.txt style
+ */
+static void print_path(const DecisionTree* tree, const int* parent, const uint8_t* parent_code,
+                       int node) {
+    int path[MAX_ROUNDS * 8];
+    int length = 0;
+    for (int n = node; n != TREE_ROOT && parent[n] != TREE_NONE &&
+                       length < (int)(sizeof(path) / sizeof(path[0])); n = parent[n]) {
+        path[length++] = n;
+    }
+    for (int i = length - 1; i >= 0; i--) {
+        char word[WORD_LENGTH + 1], pattern[WORD_LENGTH + 1];
+        tree_guess(tree, parent[path[i]], word);
+        decodeFeedback(parent_code[path[i]], pattern);
+        printf("%s %s%d ", word, pattern, length - i);
+    }
+}
+
+int main(int argc, char** argv) {
+    const char* words_file = "wordList.txt";
+    const char* solutions_file = "solutionList.txt";
+    const char* tree_file = TREE_FILE;
+    int max_depth = MAX_ROUNDS;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--words") == 0 && i + 1 < argc) {
+            words_file = argv[++i];
+        } else if (strcmp(argv[i], "--solutions") == 0 && i + 1 < argc) {
+            solutions_file = argv[++i];
+        } else if (strcmp(argv[i], "--depth") == 0 && i + 1 < argc) {
+            max_depth = atoi(argv[++i]);
+        } else {
+            tree_file = argv[i];
+        }
+    }
+    if (max_depth < 1) {
+        fprintf(stderr, "Depth must be at least 1\n");
+        return 1;
+    }
+
+    loadWords(words_file);
+    loadSolution(solutions_file);
+    DecisionTree tree;
+    if (!tree_load(&tree, tree_file)) {
+        fprintf(stderr, "Failed to load decision tree from %s\n", tree_file);
+        return 1;
+    }
+
+    double start = now_seconds();
+    CheckRun run = { &tree, max_depth, NULL, NULL, NULL };
+    run.legal = (bool*)malloc(tree.count * sizeof(bool));
+    run.reached = (uint8_t*)calloc(tree.count, sizeof(uint8_t));
+    run.replays = (Replay*)malloc((solutionCount > 0 ? solutionCount : 1) * sizeof(Replay));
+    int* parent = (int*)malloc(tree.count * sizeof(int));
+    uint8_t* parent_code = (uint8_t*)malloc(tree.count * sizeof(uint8_t));
+    if (!run.legal || !run.reached || !run.replays || !parent || !parent_code) {
+        fprintf(stderr, "Out of memory\n");
+        return 1;
+    }
+    pool_run(legal_worker, &run);
+    pool_run(replay_worker, &run);
+    find_parents(&tree, parent, parent_code);
+    double elapsed = now_seconds() - start;
+
+    printf("Checked %s (%d nodes) against %d solutions on %d threads in %.3f seconds\n\n",
+           tree_file, tree.count, solutionCount, pool_size(), elapsed);
+
+    // Solutions, in list order
+    int solved = 0, gaps = 0, too_deep = 0, illegal_games = 0, unmarked = 0;
+    int worst = 0;
+    long total_guesses = 0, total_score = 0;
+    int distribution[MAX_ROUNDS + 1] = {0};
+    for (int s = 0; s < solutionCount; s++) {
+        const Replay* r = &run.replays[s];
+        if (r->status == REPLAY_SOLVED) {
+            solved++;
+            total_guesses += r->guesses;
+            total_score += 10 - (r->guesses - 1);
+            if (r->guesses > worst) worst = r->guesses;
+            if (r->guesses <= MAX_ROUNDS) distribution[r->guesses]++;
+            if (r->unmarked && unmarked++ < REPORT_LIMIT) {
+                printf("Unmarked: %s is solved but has no GGGGG line\n", solutionList[s]);
+            }
+            continue;
+        }
+
+        int count = r->status == REPLAY_GAP ? gaps++ :
+                    r->status == REPLAY_ILLEGAL ? illegal_games++ : too_deep++;
+        if (count >= REPORT_LIMIT) continue;
+        printf("%s: %s at ", r->status == REPLAY_GAP ? "Gap" :
+                             r->status == REPLAY_ILLEGAL ? "Illegal" : "Too deep", solutionList[s]);
+        print_path(&tree, parent, parent_code, r->node);
+        char word[WORD_LENGTH + 1];
+        tree_guess(&tree, r->node, word);
+        if (r->status == REPLAY_GAP) {
+            char pattern[WORD_LENGTH + 1];
+            decodeFeedback(r->code, pattern);
+            printf("%s %s (no move)\n", word, pattern);
+        } else if (r->status == REPLAY_ILLEGAL) {
+            printf("%s (not in the word list)\n", word);
+        } else {
+            printf("%s (after %d guesses)\n", word, r->guesses);
+        }
+    }
+
+    // Nodes, in tree order
+    int illegal_nodes = 0, unreached = 0, extra_answers = 0;
+    CandidateSet answers;
+    candidates_clear(&answers);
+    for (int s = 0; s < solutionCount; s++) {
+        int index = dictionary_find(solutionPacked[s]);
+        if (index >= 0) candidates_add(&answers, index);
+    }
+    for (int i = 0; i < tree.count; i++) {
+        char word[WORD_LENGTH + 1];
+        tree_guess(&tree, i, word);
+        const char* problem = NULL;
+        if (!run.legal[i]) {
+            problem = illegal_nodes++ < REPORT_LIMIT ? "Illegal guess" : NULL;
+        } else if (!run.reached[i]) {
+            problem = unreached++ < REPORT_LIMIT ? "Unreached" : NULL;
+        } else if (tree_solves(&tree, i) &&
+                   !candidates_contains(&answers, dictionary_find(tree.nodes[i].word & TREE_WORD_MASK))) {
+            problem = extra_answers++ < REPORT_LIMIT ? "Not a solution" : NULL;
+        }
+        if (!problem) continue;
+        printf("%s: ", problem);
+        print_path(&tree, parent, parent_code, i);
+        printf("%s\n", word);
+    }
+
+    printf("\nSolved: %d/%d (%.2f%%)\n", solved, solutionCount,
+           solutionCount ? 100.0 * solved / solutionCount : 0.0);
+    printf("Coverage gaps: %d, too deep: %d\n", gaps, too_deep);
+    printf("Illegal guesses: %d nodes, stopping %d games\n", illegal_nodes, illegal_games);
+    printf("Dangling: %d unreached nodes, %d GGGGG lines for non-solutions\n",
+           unreached, extra_answers);
+    printf("Unmarked answers: %d\n", unmarked);
+    if (solved > 0) {
+        printf("Average guesses: %.4f, worst case: %d\n", (double)total_guesses / solved, worst);
+    }
+    // Every game counts, a failure scoring 0 as in wordle()
+    printf("Expected score: %.4f\n", solutionCount ? (double)total_score / solutionCount : 0.0);
+
+    printf("\nGuess Distribution:\n");
+    for (int i = 1; i <= MAX_ROUNDS; i++) {
+        printf("%d guesses: %d words (%.2f%%)\n", i, distribution[i],
+               solutionCount ? 100.0 * distribution[i] / solutionCount : 0.0);
+    }
+
+    bool clean = solved == solutionCount && illegal_nodes == 0 && unreached == 0 &&
+                 extra_answers == 0 && unmarked == 0;
+    free(run.legal);
+    free(run.reached);
+    free(run.replays);
+    free(parent);
+    free(parent_code);
+    tree_free(&tree);
+    return clean ? 0 : 1;
+}
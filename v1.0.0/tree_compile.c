@@ -0,0 +1,121 @@
+/**
+ * tree_compile.c - Decision tree compiler
+ *
+ * Converts a decision tree in any format tree_load() reads (tree_u.txt,
+ * tree_l.txt, tree_base.txt or an existing binary tree) into the binary
+ * format that the decision tree strategy maps at startup. The tree is
+ * stored compact: identical subtrees once, and only the children each
+ * node has.
+ *
+ * With --strategy, a live strategy is compiled instead: it is played
+ * against every solution (evaluate.h) and each move it makes becomes a
+ * tree node, so the decision tree player reproduces it without searching.
+ *
+ * Usage: ./tree_compile [input] [output]
+ *        ./tree_compile --strategy entropy|minimax|frequency|tree [output]
+ *        defaults: tree_u.txt tree.bin
+ *        an output name not ending in ".bin" is written as text
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include "tree.h"
+#include "evaluate.h"
+
+static const char* strategy_names[] = { "entropy", "minimax", "frequency", "tree" };
+
+/**
+ * Tells whether a file name ends with a suffix
+ */
+static int ends_with(const char* name, const char* suffix) {
+    size_t length = strlen(name), suffix_length = strlen(suffix);
+    return length >= suffix_length && strcmp(name + length - suffix_length, suffix) == 0;
+}
+
+/**
+ * Compiles a live strategy over the word lists in the working directory
+ * @return true on success
+ */
+static bool compile_live(const char* name, DecisionTree* tree) {
+    int strategy = -1;
+    for (int i = 0; i < (int)(sizeof(strategy_names) / sizeof(strategy_names[0])); i++) {
+        if (strcmp(name, strategy_names[i]) == 0) strategy = i;
+    }
+    if (strategy < 0) {
+        fprintf(stderr, "Unknown strategy %s\n", name);
+        return false;
+    }
+
+    loadWords("wordList.txt");
+    loadSolution("solutionList.txt");
+    Evaluation eval;
+    if (!compile_strategy((Strategy)strategy, tree, &eval)) {
+        fprintf(stderr, "Failed to compile the %s strategy\n", name);
+        return false;
+    }
+    printf("Compiled the %s strategy over %d solutions: %d states, "
+           "average guesses %.4f, worst case %d, failures %d\n",
+           name, eval.answers, eval.states,
+           eval.solved ? (double)eval.total_guesses / eval.solved : 0.0,
+           eval.worst, eval.answers - eval.solved);
+    evaluation_free(&eval);
+    return true;
+}
+
+int main(int argc, char** argv) {
+    const char* strategy = NULL;
+    int first = 1;
+    if (argc > 2 && strcmp(argv[1], "--strategy") == 0) {
+        strategy = argv[2];
+        first = 3;
+    }
+    const char* input = !strategy && argc > first ? argv[first] : TREE_FILE;
+    int output_arg = strategy ? first : first + 1;
+    const char* output = argc > output_arg ? argv[output_arg] : TREE_BINARY_FILE;
+
+    DecisionTree tree;
+    if (strategy) {
+        if (!compile_live(strategy, &tree)) {
+            return 1;
+        }
+        input = strategy;
+    } else if (!tree_load(&tree, input)) {
+        fprintf(stderr, "Failed to load decision tree from %s\n", input);
+        return 1;
+    }
+
+    // A compiled strategy comes out as a tree being built
+    if (tree.tables) {
+        DecisionTree compact;
+        bool ok = tree_compress(&compact, &tree);
+        tree_free(&tree);
+        if (!ok) {
+            fprintf(stderr, "Failed to compress the tree\n");
+            return 1;
+        }
+        tree = compact;
+    }
+
+    int leaves = 0;
+    for (int i = 0; i < tree.count; i++) {
+        if (tree.nodes[i].table == TREE_EMPTY) leaves++;
+    }
+
+    bool binary = ends_with(output, ".bin");
+    if (!(binary ? tree_save_binary(&tree, output) : tree_save_text(&tree, output))) {
+        fprintf(stderr, "Failed to write %s\n", output);
+        tree_free(&tree);
+        return 1;
+    }
+
+    if (binary) {
+        printf("Compiled %s -> %s: %d nodes (%d leaves), %d edge words, %zu bytes\n",
+               input, output, tree.count, leaves, tree.edge_count,
+               sizeof(TreeFileHeader) + tree.count * sizeof(TreeNode) +
+               tree.edge_count * sizeof(uint32_t));
+    } else {
+        printf("Compiled %s -> %s: %d nodes (%d leaves)\n", input, output, tree.count, leaves);
+    }
+    tree_free(&tree);
+    return 0;
+}
@@ -0,0 +1,64 @@
+/**
+ * word_query.c - Lists the words matching a pattern query
+ *
+ * Answers queries such as "S?A?E +R -T" (S first, A third, E last,
+ * contains R, no T) from the letter-position index of pattern.h, against
+ * wordList.txt or, with --solutions, solutionList.txt. Matching words are
+ * printed one per line in list order, followed by their number.
+ *
+ * Usage: ./word_query [--solutions] [--limit N] QUERY...
+ *        the query terms may be given as one argument or several
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "wordle.h"
+#include "candidates.h"
+#include "pattern.h"
+
+// ============= Constants =============
+#define QUERY_TEXT_MAX 256
+
+int main(int argc, char** argv) {
+    bool solutions = false;
+    int limit = -1;
+    char text[QUERY_TEXT_MAX] = "";
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--solutions") == 0) {
+            solutions = true;
+        } else if (strcmp(argv[i], "--limit") == 0 && i + 1 < argc) {
+            limit = atoi(argv[++i]);
+        } else if (strlen(text) + strlen(argv[i]) + 2 <= sizeof(text)) {
+            strcat(text, " ");
+            strcat(text, argv[i]);
+        } else {
+            fprintf(stderr, "Query too long\n");
+            return 1;
+        }
+    }
+
+    PatternQuery query;
+    if (!pattern_parse(text, &query)) {
+        fprintf(stderr, "Invalid query: %s\n", text);
+        fprintf(stderr, "Usage: %s [--solutions] [--limit N] PATTERN [+LETTERS] [-LETTERS]\n",
+                argv[0]);
+        return 1;
+    }
+
+    loadWords("wordList.txt");
+    loadSolution("solutionList.txt");
+    const LetterIndex* index = solutions ? pattern_solutions() : pattern_words();
+    const char (*list)[WORD_LENGTH + 1] = solutions ? solutionList : wordList;
+
+    CandidateSet result;
+    int count = pattern_match(index, &query, &result);
+    int shown = 0;
+    for (int i = candidates_next(&result, 0); i >= 0; i = candidates_next(&result, i + 1)) {
+        if (limit >= 0 && shown >= limit) break;
+        printf("%s\n", list[i]);
+        shown++;
+    }
+    printf("%d matching %s\n", count, solutions ? "solutions" : "words");
+    return 0;
+}
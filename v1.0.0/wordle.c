@@ -9,6 +9,9 @@
  */
 
 #include "wordle.h"
+#include "feedback.h"
+#include "columns.h"
+#include "pattern.h"
 #include <string.h>
 #include <stdlib.h>
 #include <stdio.h>
@@ -20,48 +23,197 @@ char wordList[MAX_WORDS][WORD_LENGTH + 1];
 int wordCount = 0;
 char solutionList[SOLUTION_LENGTH][WORD_LENGTH + 1];
 int solutionCount = 0;
+uint32_t wordPacked[MAX_WORDS];
+uint32_t solutionPacked[SOLUTION_LENGTH];
+
+// ============= Word Index =============
+// Open-addressing tables over the packed lists, filled while loading, so
+// dictionary and solution lookups cost one hash and a short probe
+#define WORD_TABLE_BITS 15        // 32768 slots for MAX_WORDS words
+#define SOLUTION_TABLE_BITS 13    // 8192 slots for SOLUTION_LENGTH solutions
+
+/**
+ * Hash table over one packed list
+ */
+typedef struct {
+    int32_t* slots;          // List index + 1, 0 for an empty slot
+    int bits;
+    const uint32_t* keys;    // wordPacked or solutionPacked
+} WordTable;
+
+static int32_t word_slots[1 << WORD_TABLE_BITS];
+static int32_t solution_slots[1 << SOLUTION_TABLE_BITS];
+static const WordTable word_table = { word_slots, WORD_TABLE_BITS, wordPacked };
+static const WordTable solution_table = { solution_slots, SOLUTION_TABLE_BITS, solutionPacked };
+
+/**
+ * Finds a packed word with linear probing
+ * @return List index, or -1 if absent
+ */
+static int table_find(const WordTable* table, uint32_t key) {
+    if (key == PACKED_INVALID) return -1;
+    uint32_t mask = (1u << table->bits) - 1;
+    uint32_t slot = (key * 0x9E3779B1u) >> (32 - table->bits);   // Fibonacci hashing
+    while (table->slots[slot]) {
+        int index = table->slots[slot] - 1;
+        if (table->keys[index] == key) {
+            return index;
+        }
+        slot = (slot + 1) & mask;
+    }
+    return -1;
+}
+
+/**
+ * Adds a list entry unless its word is present, so the first copy of a duplicate wins
+ */
+static void table_insert(const WordTable* table, int index) {
+    uint32_t key = table->keys[index];
+    if (key == PACKED_INVALID || table_find(table, key) >= 0) {
+        return;
+    }
+    uint32_t mask = (1u << table->bits) - 1;
+    uint32_t slot = (key * 0x9E3779B1u) >> (32 - table->bits);
+    while (table->slots[slot]) {
+        slot = (slot + 1) & mask;
+    }
+    table->slots[slot] = index + 1;
+}
+
+/**
+ * Stores one line of a word file as packed and canonical text forms
+ * Case is folded once here; a line that is not a word keeps its text and
+ * gets PACKED_INVALID, so no lookup can match it.
+ */
+static void store_word(const char* line, char text[WORD_LENGTH + 1], uint32_t* packed) {
+    *packed = strlen(line) == WORD_LENGTH ? packWord(line) : PACKED_INVALID;
+    if (*packed != PACKED_INVALID) {
+        unpackWord(*packed, text);
+    } else {
+        strncpy(text, line, WORD_LENGTH);
+        text[WORD_LENGTH] = '\0';
+    }
+}
 
 /**
  * Checks a guessed word against the solution
- * Returns a string of G/Y/B representing:
- * G - Correct letter in correct position
- * Y - Correct letter in wrong position
- * B - Letter not in word
+ * Greens are matched first, then yellows left to right, each solution
+ * letter being used at most once.
  */
-char* checkWord(const char solution[WORD_LENGTH + 1], const char guess[WORD_LENGTH + 1]) {
-    char* match_g = (char*)malloc((WORD_LENGTH + 1) * sizeof(char));
+uint8_t checkWordCode(const char solution[WORD_LENGTH + 1], const char guess[WORD_LENGTH + 1]) {
     char matched_solution[WORD_LENGTH] = {0};
+    uint8_t digits[WORD_LENGTH] = {0};
     
     // First pass: Find exact matches (G)
     for (int i = 0; i < WORD_LENGTH; i++) {
         if (guess[i] == solution[i]) {
-            match_g[i] = 'G';
-            matched_solution[i] = 'G';
-        } else {
-            match_g[i] = 'B';
+            digits[i] = 2;
+            matched_solution[i] = 1;
         }
     }
     
     // Second pass: Find partial matches (Y)
     for (int i = 0; i < WORD_LENGTH; i++) {
-        if (match_g[i] == 'B') {
+        if (digits[i] == 0) {
             for (int j = 0; j < WORD_LENGTH; j++) {
-                if (matched_solution[j] == 0 && guess[i] == solution[j]) {
-                    match_g[i] = 'Y';
-                    matched_solution[j] = 'Y';
+                if (!matched_solution[j] && guess[i] == solution[j]) {
+                    digits[i] = 1;
+                    matched_solution[j] = 1;
                     break;
                 }
             }
         }
     }
     
-    match_g[WORD_LENGTH] = '\0';
+    uint8_t code = 0;
+    for (int i = 0; i < WORD_LENGTH; i++) {
+        code = code * 3 + digits[i];
+    }
+    return code;
+}
+
+/**
+ * Checks a guessed word against the solution
+ * Returns a string of G/Y/B representing:
+ * G - Correct letter in correct position
+ * Y - Correct letter in wrong position
+ * B - Letter not in word
+ */
+char* checkWord(const char solution[WORD_LENGTH + 1], const char guess[WORD_LENGTH + 1]) {
+    char* match_g = (char*)malloc((WORD_LENGTH + 1) * sizeof(char));
+    if (match_g) {
+        decodeFeedback(checkWordCode(solution, guess), match_g);
+    }
     return match_g;
 }
 
+/**
+ * Packs a G/Y/B string into a feedback code
+ */
+uint8_t encodeFeedback(const char feedback[WORD_LENGTH + 1]) {
+    uint8_t code = 0;
+    for (int i = 0; i < WORD_LENGTH; i++) {
+        switch (feedback[i]) {
+            case 'G': code = code * 3 + 2; break;
+            case 'Y': code = code * 3 + 1; break;
+            case 'B': code = code * 3; break;
+            default: return PATTERN_INVALID;
+        }
+    }
+    return code;
+}
+
+/**
+ * Expands a feedback code into a G/Y/B string
+ */
+void decodeFeedback(uint8_t code, char feedback[WORD_LENGTH + 1]) {
+    for (int i = WORD_LENGTH - 1; i >= 0; i--) {
+        int digit = code % 3;
+        feedback[i] = digit == 2 ? 'G' : (digit == 1 ? 'Y' : 'B');
+        code /= 3;
+    }
+    feedback[WORD_LENGTH] = '\0';
+}
+
+/**
+ * Packs a word into 5 bits per letter
+ */
+uint32_t packWord(const char word[WORD_LENGTH + 1]) {
+    uint32_t packed = 0;
+    for (int i = 0; i < WORD_LENGTH; i++) {
+        int letter = toupper((unsigned char)word[i]) - 'A';
+        if (letter < 0 || letter >= 26) return PACKED_INVALID;
+        packed = (packed << 5) | (uint32_t)letter;
+    }
+    return packed;
+}
+
+/**
+ * Packs a word only if it is exactly WORD_LENGTH upper case letters
+ */
+uint32_t packCanonical(const char* word) {
+    uint32_t packed = 0;
+    for (int i = 0; i < WORD_LENGTH; i++) {
+        if (word[i] < 'A' || word[i] > 'Z') return PACKED_INVALID;
+        packed = (packed << 5) | (uint32_t)(word[i] - 'A');
+    }
+    return word[WORD_LENGTH] == '\0' ? packed : PACKED_INVALID;
+}
+
+/**
+ * Expands a packed word into upper case letters
+ */
+void unpackWord(uint32_t packed, char word[WORD_LENGTH + 1]) {
+    for (int i = WORD_LENGTH - 1; i >= 0; i--) {
+        word[i] = (char)('A' + (packed & 31));
+        packed >>= 5;
+    }
+    word[WORD_LENGTH] = '\0';
+}
+
 /**
  * Loads word dictionary from file
- * Converts all words to uppercase
+ * Words are packed once and kept as upper case text for output
  */
 void loadWords(const char* filename) {
     FILE* file = fopen(filename, "r");
@@ -73,23 +225,22 @@ void loadWords(const char* filename) {
     char buffer[WORD_LENGTH + 2];
     while (fgets(buffer, sizeof(buffer), file) != NULL) {
         buffer[strcspn(buffer, "\n")] = '\0';
-        // Convert to uppercase
-        for(int i = 0; buffer[i]; i++) {
-            buffer[i] = toupper(buffer[i]);
-        }
-        strcpy(wordList[wordCount], buffer);
-        wordList[wordCount][WORD_LENGTH] = '\0';
+        store_word(buffer, wordList[wordCount], &wordPacked[wordCount]);
+        table_insert(&word_table, wordCount);
         wordCount++;
         if (wordCount >= MAX_WORDS) break;
     }
     
     printf("Loaded %d words from %s\n", wordCount, filename);
     fclose(file);
+    columns_build();
+    pattern_index_words();
+    feedback_attach_cache();
 }
 
 /**
  * Loads solution list from file
- * Converts all words to uppercase
+ * Words are packed once and kept as upper case text for output
  */
 void loadSolution(const char* filename) {
     FILE* file = fopen(filename, "r");
@@ -101,23 +252,23 @@ void loadSolution(const char* filename) {
     char buffer[WORD_LENGTH + 2];
     while (fgets(buffer, sizeof(buffer), file) != NULL) {
         buffer[strcspn(buffer, "\n")] = '\0';
-        // Convert to uppercase
-        for(int i = 0; buffer[i]; i++) {
-            buffer[i] = toupper(buffer[i]);
-        }
-        strcpy(solutionList[solutionCount], buffer);
-        solutionList[solutionCount][WORD_LENGTH] = '\0';
+        store_word(buffer, solutionList[solutionCount], &solutionPacked[solutionCount]);
+        table_insert(&solution_table, solutionCount);
         solutionCount++;
         if (solutionCount >= SOLUTION_LENGTH) break;
     }
     
     printf("Loaded %d solutions from %s\n", solutionCount, filename);
     fclose(file);
+    pattern_index_solutions();
 }
 
 /**
  * Main game control function
- * Manages game flow and player interaction
+ * Manages game flow and player interaction. The player is called with a
+ * NULL state and keeps its own. An illegal guess is asked again within the
+ * round; a player with no move, or still illegal after MAX_RETRIES tries,
+ * ends the game as a failure.
  */
 void wordle(const char solution[WORD_LENGTH + 1], Player *player) {
     // Load dictionaries if needed
@@ -127,44 +278,55 @@ void wordle(const char solution[WORD_LENGTH + 1], Player *player) {
     if (solutionCount == 0) {
         loadSolution("solutionList.txt");
     }
+    printf("Checking solution: %s\n", solution);
     if (invalid(solution)) {
+        printf("Solution is not in the solution list\n");
         return;
     }
+    printf("Solution is valid\n");
     
     printf("Starting game with solution: %s\n", solution);
     
-    // Initialize feedback for first round
-    char* lastResult = (char*)malloc(WORD_LENGTH * sizeof(char));
-    for (int i = 0; i < WORD_LENGTH; i++) {
-        lastResult[i] = ' ';
-    }
-    lastResult[WORD_LENGTH] = '\0';
+    // The game lives on the stack: the player writes into guess
+    uint8_t lastCode = PATTERN_NONE;
+    char guess[WORD_LENGTH + 1];
+    char result[WORD_LENGTH + 1];
     
     // Main game loop
     int i;
     for (i = 0; i < MAX_ROUNDS; i++) {
-        char* guess = (*player)(lastResult);
-        printf("Round %d: Guessing %s\n", i+1, guess);
+        bool moved = (*player)(NULL, lastCode, guess);
+        if (moved) {
+            printf("Round %d: Guessing %s\n", i+1, guess);
+        }
         
         // Validate guess
-        while (not_legal(guess)) {
+        for (int retry = 0; moved && not_legal(guess); retry++) {
+            if (retry == MAX_RETRIES) {
+                moved = false;
+                break;
+            }
             printf("Illegal guess, trying again\n");
-            guess = (*player)(lastResult);
+            moved = (*player)(NULL, PATTERN_INVALID, guess);
+        }
+        if (!moved) {
+            printf("No legal guess, giving up\n");
+            i = MAX_ROUNDS;
+            break;
         }
         
         // Check guess and provide feedback
-        char* result = checkWord(solution, guess);
+        uint8_t code = feedback_code(solution, guess);
+        decodeFeedback(code, result);
         printf("Feedback: %s\n", result);
         
         // Check for win
-        if (strcmp(solution, guess) == 0) {
+        if (code == PATTERN_WIN) {
             printf("Correct guess!\n");
             break;
         }
         
-        free(guess);
-        free(lastResult);
-        lastResult = result;
+        lastCode = code;
     }
     
     // Game end scoring
@@ -175,35 +337,49 @@ void wordle(const char solution[WORD_LENGTH + 1], Player *player) {
         printf("Succeeded in %d guesses\n", i+1);
         printf("%d\n", 10 - i);
     }
-    
-    free(lastResult);
 }
 
 /**
  * Checks if a word exists in the dictionary
+ * Only the canonical upper case spelling is legal, as stored in wordList.
  */
 bool not_legal(const char* guess) {
-    for (int i = 0; i < wordCount; i++) {
-        if (strcmp(wordList[i], guess) == 0) {
-            return false;
-        }
+    if (!guess) {
+        return true;  // A player with no move
     }
-    return true;
+    return dictionary_find(packCanonical(guess)) < 0;
 }
 
 /**
  * Validates if a word is in the solution list
  */
 bool invalid(const char* solution) {
-    printf("Checking solution: %s\n", solution);
-    for (int i = 0; i < SOLUTION_LENGTH; i++) {
-        if (strcmp(solution, solutionList[i]) == 0) {
-            printf("Solution is valid\n");
-            return false;
+    if (!solution) {
+        return true;
+    }
+    return solution_find(packCanonical(solution)) < 0;
+}
+
+int dictionary_find(uint32_t packed) {
+    return table_find(&word_table, packed);
+}
+
+int solution_find(uint32_t packed) {
+    return table_find(&solution_table, packed);
+}
+
+/**
+ * FNV-1a hash over a list of loaded words
+ */
+uint64_t hashWords(const char (*words)[WORD_LENGTH + 1], int count) {
+    uint64_t hash = 14695981039346656037ULL;
+    for (int i = 0; i < count; i++) {
+        for (int j = 0; j < WORD_LENGTH; j++) {
+            hash = (hash ^ (uint8_t)words[i][j]) * 1099511628211ULL;
         }
+        hash = (hash ^ '\n') * 1099511628211ULL;
     }
-    printf("Solution is not in the solution list\n");
-    return true;
+    return hash;
 }
 
 /**
@@ -10,20 +10,42 @@
 #define WORDLE_H
 
 #include <stdbool.h>
+#include <stdint.h>
 
 // ============= Game Constants =============
 #define WORD_LENGTH 5        // Length of each word in the game
 #define MAX_ROUNDS 10        // Maximum number of guessing rounds allowed
 #define MAX_WORDS 15000      // Maximum number of words in the dictionary
 #define SOLUTION_LENGTH 2500 // Maximum number of possible solution words
+#define MAX_RETRIES 100      // Illegal guesses allowed in one round before the game ends
+
+// ============= Feedback Codes =============
+// Feedback packed as base-3 digits, first letter most significant,
+// with B=0, Y=1, G=2
+#define PATTERN_COUNT 243    // Number of possible feedback patterns (3^5)
+#define PATTERN_WIN 242      // Code of "GGGGG"
+#define PATTERN_INVALID 255  // Returned for strings that are not a pattern
+#define PATTERN_NONE 254     // Passed to a player before the first guess of a game
+
+// ============= Packed Words =============
+// A word packed as 5-bit letter numbers (A=0), first letter most significant.
+// Words are packed once at load; packed values are the engine's keys for
+// lookups, equality, tree nodes and caches, and text is for input and output.
+#define PACKED_WORD_BITS (5 * WORD_LENGTH)   // 25 bits
+#define PACKED_INVALID 0xFFFFFFFFu           // Returned for non-letter words
 
 /**
  * Player strategy function type
- * @param lastResult Previous guess feedback ('G'=correct position, 
- *                  'Y'=wrong position, 'B'=not in word)
- * @return Next word to guess, must be allocated dynamically
+ * The guess is written to the caller's buffer, so a game allocates nothing.
+ * @param state Opaque per-game state kept by the caller between rounds, or
+ *              NULL for the player's own state of the calling thread
+ * @param lastCode Feedback code of the previous guess, PATTERN_NONE on the
+ *                 first round of a game, PATTERN_INVALID if the previous
+ *                 guess was rejected
+ * @param guess Output, next word to guess
+ * @return false if the player has no move
  */
-typedef char* (*Player)(const char lastResult[WORD_LENGTH + 1]);
+typedef bool (*Player)(void* state, uint8_t lastCode, char guess[WORD_LENGTH + 1]);
 
 // ============= Core Game Functions =============
 
@@ -48,6 +70,50 @@ void loadSolution(const char* filename);
 char* checkWord(const char solution[WORD_LENGTH + 1], 
                 const char guess[WORD_LENGTH + 1]);
 
+/**
+ * Evaluates a guess against the solution without allocating
+ * @param solution Target word
+ * @param guess Player's guessed word
+ * @return Feedback code (0-242)
+ */
+uint8_t checkWordCode(const char solution[WORD_LENGTH + 1],
+                      const char guess[WORD_LENGTH + 1]);
+
+/**
+ * Packs a G/Y/B feedback string into its code
+ * @param feedback Feedback string
+ * @return Feedback code, or PATTERN_INVALID for any other string
+ */
+uint8_t encodeFeedback(const char feedback[WORD_LENGTH + 1]);
+
+/**
+ * Expands a feedback code into its G/Y/B string
+ * @param code Feedback code
+ * @param feedback Output buffer
+ */
+void decodeFeedback(uint8_t code, char feedback[WORD_LENGTH + 1]);
+
+/**
+ * Packs a word into PACKED_WORD_BITS bits, ignoring case
+ * @param word Word to pack
+ * @return Packed word, or PACKED_INVALID if a character is not a letter
+ */
+uint32_t packWord(const char word[WORD_LENGTH + 1]);
+
+/**
+ * Packs a word in canonical form: WORD_LENGTH upper case letters, nothing more
+ * @param word Word to pack
+ * @return Packed word, or PACKED_INVALID for any other string
+ */
+uint32_t packCanonical(const char* word);
+
+/**
+ * Expands a packed word into upper case letters
+ * @param packed Value from packWord
+ * @param word Output buffer
+ */
+void unpackWord(uint32_t packed, char word[WORD_LENGTH + 1]);
+
 /**
  * Main game control function
  * @param solution Word to be guessed
@@ -65,22 +131,46 @@ char* get_random_word(void);
 
 /**
  * Checks if a guess is legal (exists in dictionary)
- * @param guess Word to check
- * @return false if word is legal, true if illegal
+ * @param guess Word to check, NULL if the player had no move
+ * @return false if word is legal, true if illegal (or NULL)
  */
 bool not_legal(const char* guess);
 
+/**
+ * Hashes a loaded word list, e.g. to key files derived from it
+ * @param words Word array such as wordList or solutionList
+ * @param count Number of words
+ * @return 64-bit FNV-1a hash of the words in order
+ */
+uint64_t hashWords(const char (*words)[WORD_LENGTH + 1], int count);
+
 /**
  * Validates if a word is in solution list
  * @param solution Word to check
- * @return false if valid, true if invalid
+ * @return false if valid, true if invalid (or NULL)
  */
 bool invalid(const char* solution);
 
+/**
+ * Looks a word up in the dictionary's hash index
+ * @param packed Word from packWord (so matched in any case)
+ * @return Index of its first occurrence in wordList, or -1
+ */
+int dictionary_find(uint32_t packed);
+
+/**
+ * Looks a word up in the solution list's hash index
+ * @param packed Word from packWord (so matched in any case)
+ * @return Index of its first occurrence in solutionList, or -1
+ */
+int solution_find(uint32_t packed);
+
 // ============= Global Data =============
 extern char wordList[MAX_WORDS][WORD_LENGTH + 1];        // Dictionary words
 extern int wordCount;                                    // Number of words loaded
 extern char solutionList[SOLUTION_LENGTH][WORD_LENGTH + 1]; // Possible solutions
 extern int solutionCount;                               // Number of solutions
+extern uint32_t wordPacked[MAX_WORDS];                   // wordList packed, the key for lookups
+extern uint32_t solutionPacked[SOLUTION_LENGTH];         // solutionList packed
 
 #endif
\ No newline at end of file